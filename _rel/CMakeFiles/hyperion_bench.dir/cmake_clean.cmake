@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hyperion_bench.dir/src/benchmark.cpp.o"
+  "CMakeFiles/hyperion_bench.dir/src/benchmark.cpp.o.d"
+  "hyperion_bench"
+  "hyperion_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hyperion_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
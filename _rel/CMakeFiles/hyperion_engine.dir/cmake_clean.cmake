@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hyperion_engine.dir/src/main.cpp.o"
+  "CMakeFiles/hyperion_engine.dir/src/main.cpp.o.d"
+  "hyperion_engine"
+  "hyperion_engine.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hyperion_engine.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -1,98 +1,353 @@
 #pragma once
 
+#include "memory.hpp"
 #include <atomic>
 #include <cstdint>
 #include <cstddef>
 #include <new>
+#include <string>
 
-// Platform Abstraction Layer (PAL) for Virtual Memory Management
-#if defined(_WIN32)
-    #define NOMINMAX
-    #define WIN32_LEAN_AND_MEAN
-    #include <windows.h>
-#else
-    #include <sys/mman.h>
-    #include <unistd.h>
-#endif
+enum class ArenaError { None, OutOfSpace, MmapFailed, TooLarge, FileFailed, BadFile, IndexFull };
 
-enum class ArenaError { None, OutOfSpace, MmapFailed, TooLarge };
+/// \brief First page of a file-backed Arena (see Arena::open()).
+/// \details Identifies the file and carries owner-defined state that must survive a restart,
+/// such as how far the Arena has been written. It lives in the shared mapping, so every store
+/// reaches the file without a syscall.
+struct ArenaFileHeader {
+    static constexpr std::uint64_t MAGIC = 0x314E4F4952455048ull; // "HPERION1"
+
+    std::uint64_t magic;
+    std::uint64_t size;                 // Arena bytes, excluding this header and the read slack.
+    std::atomic<std::uint64_t> meta[14]; // Owner-defined words (zero in a new file).
+};
+
+/// \brief First page of a shared-memory Arena (see Arena::create_shared()).
+/// \details Tells attaching processes where the Arena starts: the creator's owner lays its own
+/// shared state out in the `prefix` bytes in front of it and describes them in `meta`. `magic`
+/// is stored last (publish()), so a process never attaches to a half-built region.
+struct ArenaSharedHeader {
+    static constexpr std::uint64_t MAGIC = 0x314D485352455048ull; // "HPERSHM1"
+
+    std::atomic<std::uint64_t> magic;
+    std::uint64_t size;                  // Arena bytes, excluding the prefix and the read slack.
+    std::uint64_t prefix;                // Bytes from the start of the object to Arena offset 0.
+    std::atomic<std::uint64_t> meta[13]; // Owner-defined words (zero in a new object).
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "File header words must be plain 64-bit stores");
 
 /// \brief Monotonic Bump Allocator backed by a contiguous OS memory mapping.
 ///
 /// \details
 /// Bypasses the user-space heap (malloc/free) to eliminate fragmentation and metadata overhead.
-/// Allocations are O(1) via an atomic fetch_add. Deallocation is impossible until destruction.
+/// Allocations are O(1) via an atomic bump. Individual deallocation is impossible; a caller that
+/// partitions the region (e.g. the engine's compacting half-spaces) can redirect the bump
+/// pointer with reset() and return evacuated pages to the OS with discard().
+///
+/// Offsets are 64-bit. The full size is reserved as address space up front and backed by
+/// physical pages only as allocation reaches them (first touch on Linux, chunked commits on
+/// Windows), so a large Arena grows in place and existing entries never move.
+///
+/// MemoryOptions::pages requests huge-page backing to cut dTLB misses on random reads;
+/// page_mode() reports what the OS actually granted. MemoryOptions::prefault / lock back
+/// (and pin) the whole region at create(), trading startup time for fault-free writes.
+/// MemoryOptions::numa_node binds the region to one node before any page is touched.
+///
+/// open() maps a file instead of anonymous memory: entries written to the Arena outlive the
+/// process, and a restarted owner finds them where it left them.
+///
+/// create_shared() maps a named shared-memory object instead, which other processes map
+/// read-only with attach_shared(). Entries are addressed by offset, so every process resolves
+/// them against its own base address.
 class Arena {
 public:
-    Arena() : base_(nullptr), size_(0), offset_(0) {}
+    /// \brief Readable slack mapped past the end of the Arena.
+    /// \details Optimistic readers may dereference a stale offset whose header decodes to
+    /// garbage lengths before their SeqLock validation fails. A header at any in-range offset
+    /// spans at most 8 + 2 * 65535 bytes, so this tail keeps every such read inside the mapping.
+    static constexpr std::size_t READ_SLACK = 256 * 1024;
+
+    /// Largest reservable Arena (64 TiB, well inside a 47-bit user address space).
+    static constexpr std::uint64_t MAX_BYTES = 1ull << 46;
+
+    /// Bytes in front of offset 0 of a file-backed Arena, holding its ArenaFileHeader.
+    static constexpr std::size_t FILE_HEADER = 4096;
 
-    /// \brief Maps a contiguous region of virtual memory.
-    static Arena create(std::size_t size_bytes, ArenaError& err) {
+    Arena() : base_(nullptr), size_(0), limit_(0), offset_(0) {}
+
+    /// \brief Reserves a contiguous region of virtual memory.
+    /// \details Base and transparent huge pages are reserved lazily (MAP_NORESERVE on Linux,
+    /// reserve-only on Windows, where alloc() commits in COMMIT_CHUNK steps). Explicit huge
+    /// pages are taken from the pool up front and fall back to smaller pages if it runs short.
+    static Arena create(std::size_t size_bytes, ArenaError& err, const MemoryOptions& mem = {}) {
         Arena a;
         err = ArenaError::None;
-        if (size_bytes > UINT32_MAX) { err = ArenaError::TooLarge; return a; }
+        if (size_bytes > MAX_BYTES) { err = ArenaError::TooLarge; return a; }
 
-        void* ptr = nullptr;
+        MappedRegion r = map_region(size_bytes + READ_SLACK, mem, true);
+        if (r.ptr == nullptr) { err = ArenaError::MmapFailed; return a; }
 
-        #if defined(_WIN32)
-            // MEM_RESERVE | MEM_COMMIT guarantees zero-initialized pages on demand.
-            ptr = VirtualAlloc(nullptr, size_bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
-            if (ptr == nullptr) { err = ArenaError::MmapFailed; return a; }
-        #else
-            // MAP_ANONYMOUS requests zero-filled pages from the kernel.
-            ptr = ::mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-            if (ptr == MAP_FAILED) { err = ArenaError::MmapFailed; return a; }
-        #endif
+        a.base_ = static_cast<std::uint8_t*>(r.ptr);
+        a.map_ = r;
+        a.resident_ = mem.resident();
+        a.size_ = size_bytes;
+        a.limit_ = a.size_;
 
-        a.base_ = static_cast<std::uint8_t*>(ptr);
-        a.size_ = static_cast<std::uint32_t>(size_bytes);
-        
         // Reserve offset 0-7 to ensure no valid pointer has offset 0 (null-equivalent).
         // Alignment ensures 64-bit aligned data starts at offset 8.
-        a.offset_.store(8, std::memory_order_relaxed); 
+        a.offset_.store(8, std::memory_order_relaxed);
+
+        #if defined(_WIN32)
+            // Large pages and resident mappings come back fully committed.
+            if (r.mode != PageMode::Small || a.resident_) a.committed_ = r.bytes;
+            if (!a.commit_to(8)) { err = ArenaError::MmapFailed; return Arena(); }
+        #endif
         return a;
     }
 
-    ~Arena() {
-        if (base_) {
-            #if defined(_WIN32)
-                VirtualFree(base_, 0, MEM_RELEASE);
-            #else
-                ::munmap(base_, size_);
-            #endif
+    /// \brief Maps a file-backed Arena at `path`, creating the file if it does not exist.
+    /// \details The file holds an ArenaFileHeader page, the Arena, then READ_SLACK, and is mapped
+    /// shared (see map_file() for page, prefault and lock behaviour). Allocation starts at offset 8
+    /// either way; an owner reopening a file restores its own allocation point with reset()/alloc().
+    /// \param err FileFailed if the file cannot be created or mapped; BadFile if it exists but was
+    ///            not written by an Arena of `size_bytes`.
+    static Arena open(const char* path, std::size_t size_bytes, ArenaError& err, const MemoryOptions& mem = {}) {
+        Arena a;
+        err = ArenaError::None;
+        if (size_bytes > MAX_BYTES) { err = ArenaError::TooLarge; return a; }
+
+        MappedFile f;
+        FileStatus st = map_file(path, FILE_HEADER + size_bytes + READ_SLACK, mem, f);
+        if (st == FileStatus::Failed) { err = ArenaError::FileFailed; return a; }
+        if (st == FileStatus::SizeMismatch) { err = ArenaError::BadFile; return a; }
+
+        auto* hdr = static_cast<ArenaFileHeader*>(f.map.ptr);
+        // A zero magic is a file created but never initialized (e.g. killed during open).
+        if (hdr->magic == 0) {
+            hdr->size = size_bytes;
+            std::atomic_thread_fence(std::memory_order_release);
+            hdr->magic = ArenaFileHeader::MAGIC;
+        } else if (hdr->magic != ArenaFileHeader::MAGIC || hdr->size != size_bytes) {
+            unmap_file(f);
+            err = ArenaError::BadFile;
+            return a;
+        }
+
+        a.reopened_ = st == FileStatus::Opened;
+        a.file_ = f;
+        a.map_ = f.map;
+        a.base_ = static_cast<std::uint8_t*>(f.map.ptr) + FILE_HEADER;
+        a.resident_ = mem.resident();
+        a.size_ = size_bytes;
+        a.limit_ = a.size_;
+        a.committed_ = size_bytes + READ_SLACK; // A file view is committed in full.
+        a.offset_.store(8, std::memory_order_relaxed);
+        return a;
+    }
+
+    /// \brief Maps a new shared-memory Arena named `name` (see map_shared()) for one writing process.
+    /// \details The object holds an ArenaSharedHeader page and `prefix` further bytes for the
+    /// owner (rounded up to whole pages), then the Arena and READ_SLACK. It replaces any object of
+    /// that name and is unlinked again when this Arena goes; processes still attached keep their
+    /// mapping. Nobody can attach until the owner calls publish().
+    /// \param err FileFailed if the object cannot be created or mapped.
+    static Arena create_shared(const char* name, std::size_t prefix, std::size_t size_bytes, ArenaError& err,
+                               const MemoryOptions& mem = {}) {
+        Arena a;
+        err = ArenaError::None;
+        if (size_bytes > MAX_BYTES) { err = ArenaError::TooLarge; return a; }
+
+        prefix = (FILE_HEADER + prefix + FILE_HEADER - 1) / FILE_HEADER * FILE_HEADER;
+        MappedFile f;
+        if (!map_shared(name, prefix + size_bytes + READ_SLACK, true, mem, f)) { err = ArenaError::FileFailed; return a; }
+        auto* hdr = static_cast<ArenaSharedHeader*>(f.map.ptr);
+        hdr->size = size_bytes;
+        hdr->prefix = prefix;
+
+        a.shm_ = true;
+        a.shm_name_ = name;
+        a.adopt(f, prefix, size_bytes, mem.resident());
+        return a;
+    }
+
+    /// \brief Maps the shared-memory Arena `name` read-only, as published by another process.
+    /// \details The returned Arena only resolves offsets: it must never allocate or be written.
+    /// \param err FileFailed if there is no such object; BadFile if it is not a published Arena.
+    static Arena attach_shared(const char* name, ArenaError& err) {
+        Arena a;
+        err = ArenaError::None;
+        MappedFile f;
+        if (!map_shared(name, 0, false, {}, f)) { err = ArenaError::FileFailed; return a; }
+        auto* hdr = static_cast<const ArenaSharedHeader*>(f.map.ptr);
+        if (f.map.bytes < FILE_HEADER || hdr->magic.load(std::memory_order_acquire) != ArenaSharedHeader::MAGIC ||
+            hdr->prefix > f.map.bytes || f.map.bytes - hdr->prefix < hdr->size + READ_SLACK) {
+            unmap_file(f);
+            err = ArenaError::BadFile;
+            return a;
         }
+
+        a.shm_ = true;
+        a.adopt(f, hdr->prefix, hdr->size, false);
+        return a;
+    }
+
+    ~Arena() {
+        if (file_.map.ptr) unmap_file(file_);
+        else if (base_) unmap_region(map_);
+        if (!shm_name_.empty()) unlink_shared(shm_name_.c_str());
     }
 
     // Move-only semantics to manage the OS handle ownership.
-    Arena(Arena&& o) noexcept : base_(o.base_), size_(o.size_), offset_(o.offset_.load()) {
-        o.base_ = nullptr; o.size_ = 0;
+    Arena(Arena&& o) noexcept
+        : base_(o.base_), size_(o.size_), limit_(o.limit_), committed_(o.committed_),
+          map_(o.map_), file_(o.file_), shm_name_(std::move(o.shm_name_)), resident_(o.resident_),
+          reopened_(o.reopened_), shm_(o.shm_), offset_(o.offset_.load()) {
+        o.base_ = nullptr; o.size_ = 0; o.file_ = MappedFile{}; o.shm_name_.clear();
     }
     Arena& operator=(Arena&& o) = delete;
     Arena(const Arena&) = delete;
 
     /// \brief Thread-safe bump allocation.
+    /// \details A failed allocation leaves the bump pointer untouched, so [region begin, offset())
+    /// always holds exactly the entries that were allocated.
     /// \return Offset relative to base address.
-    inline ArenaError alloc(std::uint32_t size, std::uint32_t& out_offset) {
-        // atomic fetch_add is a single CPU instruction on x64/ARMv8.
-        std::uint32_t old_off = offset_.fetch_add(size, std::memory_order_acq_rel);
-        
-        if (old_off + size > size_) {
-            return ArenaError::OutOfSpace;
-        }
+    inline ArenaError alloc(std::uint64_t size, std::uint64_t& out_offset) {
+        std::uint64_t old_off = offset_.load(std::memory_order_relaxed);
+        do {
+            if (size > limit_ - old_off) return ArenaError::OutOfSpace;
+        } while (!offset_.compare_exchange_weak(old_off, old_off + size, std::memory_order_acq_rel));
+
+        #if defined(_WIN32)
+            if (!commit_to(old_off + size)) return ArenaError::OutOfSpace;
+        #endif
         out_offset = old_off;
         return ArenaError::None;
     }
 
+    /// \brief Redirects allocation to the region [begin, end). Single writer only.
+    /// \details Memory outside the region stays mapped and readable.
+    void reset(std::uint64_t begin, std::uint64_t end) {
+        limit_ = end;
+        offset_.store(begin, std::memory_order_release);
+    }
+
+    /// \brief Returns the whole pages inside [begin, end) to the OS.
+    /// \details The range stays mapped: later reads observe zeros (Linux) or stale bytes
+    /// (Windows), never a fault, so optimistic readers racing the discard remain safe.
+    /// Huge-page mappings are only released in whole huge pages, which keeps them unsplit.
+    /// A prefaulted or locked Arena keeps its pages, so reuse never faults. A file-backed Arena
+    /// punches the range out of the file instead (MADV_REMOVE), so it reads back as zeros.
+    void discard(std::uint64_t begin, std::uint64_t end) {
+        if (resident_) return;
+        const std::uintptr_t page = page_bytes(map_.mode);
+        std::uintptr_t lo = (reinterpret_cast<std::uintptr_t>(base_ + begin) + page - 1) & ~(page - 1);
+        std::uintptr_t hi = reinterpret_cast<std::uintptr_t>(base_ + end) & ~(page - 1);
+
+        #if defined(_WIN32)
+            // Only committed pages can be reset; the rest were never backed. File views keep theirs.
+            if (map_.shared) return;
+            std::uintptr_t top = reinterpret_cast<std::uintptr_t>(base_) + committed_;
+            if (hi > top) hi = top;
+            if (lo < hi) VirtualAlloc(reinterpret_cast<void*>(lo), hi - lo, MEM_RESET, PAGE_READWRITE);
+        #else
+            // Dropping shared file pages would only reload them from disk.
+            #if defined(MADV_REMOVE)
+                const int advice = map_.shared ? MADV_REMOVE : MADV_DONTNEED;
+            #else
+                if (map_.shared) return;
+                const int advice = MADV_DONTNEED;
+            #endif
+            if (lo < hi) ::madvise(reinterpret_cast<void*>(lo), hi - lo, advice);
+        #endif
+    }
+
+    /// \brief Current bump pointer (end of the last allocation).
+    std::uint64_t offset() const { return offset_.load(std::memory_order_acquire); }
+
+    /// \brief Reserved size in bytes.
+    std::uint64_t size() const { return size_; }
+
+    /// \brief Page size backing the mapping (may be smaller than requested).
+    PageMode page_mode() const { return map_.mode; }
+
+    /// \brief True if the mapping is pinned in RAM (MemoryOptions::lock was granted).
+    bool locked() const { return map_.locked; }
+
+    /// \brief NUMA node the mapping is bound to (MemoryOptions::numa_node), -1 if unbound.
+    std::int32_t numa_node() const { return map_.node; }
+
+    /// \brief Header of a file-backed Arena, nullptr for anonymous memory.
+    ArenaFileHeader* file() const {
+        return file_.map.ptr && !shm_ ? static_cast<ArenaFileHeader*>(file_.map.ptr) : nullptr;
+    }
+
+    /// \brief Header of a shared-memory Arena, nullptr otherwise.
+    /// \details Its page and the owner's prefix follow at the start of the mapping; an attached
+    /// Arena maps them read-only.
+    ArenaSharedHeader* shared() const {
+        return shm_ ? static_cast<ArenaSharedHeader*>(file_.map.ptr) : nullptr;
+    }
+
+    /// \brief Lets other processes attach to a create_shared() Arena, once the prefix is laid out.
+    void publish() {
+        shared()->magic.store(ArenaSharedHeader::MAGIC, std::memory_order_release);
+    }
+
+    /// \brief True if open() mapped a file that already existed (its entries are still there).
+    bool reopened() const { return reopened_; }
+
+    /// \brief Flushes the file header and [8, end) to disk (file-backed only; false otherwise).
+    /// \details Without it, written entries survive a process crash but not an OS crash.
+    bool sync(std::uint64_t end) const {
+        if (file() == nullptr) return false;
+        return sync_file(file_, file_.map.ptr, FILE_HEADER + end);
+    }
+
     /// \brief Resolves an offset to a raw pointer.
     /// \note No bounds check in release builds for performance.
-    inline std::uint8_t* ptr_at(std::uint32_t offset) const {
+    inline std::uint8_t* ptr_at(std::uint64_t offset) const {
         return base_ + offset;
     }
 
 private:
+    /// \brief Takes over a shared-memory mapping whose Arena starts `prefix` bytes in.
+    void adopt(const MappedFile& f, std::size_t prefix, std::size_t size_bytes, bool resident) {
+        file_ = f;
+        map_ = f.map;
+        base_ = static_cast<std::uint8_t*>(f.map.ptr) + prefix;
+        resident_ = resident;
+        size_ = size_bytes;
+        limit_ = size_;
+        committed_ = size_bytes + READ_SLACK; // A section view is committed in full.
+        offset_.store(8, std::memory_order_relaxed);
+    }
+
+    #if defined(_WIN32)
+        static constexpr std::uint64_t COMMIT_CHUNK = 64ull * 1024 * 1024;
+
+        /// \brief Commits pages so [0, end + READ_SLACK) is backed. Single writer only.
+        bool commit_to(std::uint64_t end) {
+            std::uint64_t want = end + READ_SLACK;
+            if (want <= committed_) return true;
+            std::uint64_t target = (want + COMMIT_CHUNK - 1) / COMMIT_CHUNK * COMMIT_CHUNK;
+            if (target > size_ + READ_SLACK) target = size_ + READ_SLACK;
+            if (VirtualAlloc(base_ + committed_, target - committed_, MEM_COMMIT, PAGE_READWRITE) == nullptr) return false;
+            committed_ = target;
+            return true;
+        }
+    #endif
+
     std::uint8_t* base_;
-    std::uint32_t size_;
-    // Cache-line alignment of this atomic is implicit in class layout, 
+    std::uint64_t size_;
+    std::uint64_t limit_;         // End of the current allocation region (size_ unless reset()).
+    std::uint64_t committed_ = 0; // Bytes backed by committed pages (Windows only).
+    MappedRegion map_;            // The OS mapping (size_ + READ_SLACK, page-rounded).
+    MappedFile file_;             // The backing file or shared object and its whole mapping.
+    std::string shm_name_;        // Shared object to unlink when its creator goes.
+    bool resident_ = false;       // Prefaulted or locked: discard() keeps pages backed.
+    bool reopened_ = false;       // open() found an existing file.
+    bool shm_ = false;            // file_ is a shared-memory object (create_shared/attach_shared).
+    // Cache-line alignment of this atomic is implicit in class layout,
     // but contention is low in single-writer scenarios.
-    std::atomic<std::uint32_t> offset_;
+    std::atomic<std::uint64_t> offset_;
 };
\ No newline at end of file
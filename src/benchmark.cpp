@@ -1,16 +1,22 @@
 #include "hyperion.hpp"
+#include "sharded.hpp"
+#include "write_queue.hpp"
 #include <iostream>
 #include <vector>
 #include <unordered_map>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <random>
+#include <thread>
 
 using Clock = std::chrono::high_resolution_clock;
 
-void bench_hyperion(int count) {
+template <typename DB>
+void bench_hyperion(const char* label, int count) {
     ArenaError ae;
     // 256MB Arena, 2x Slots to minimize load factor effects for fair comparison.
-    auto db = Hyperion::create(256ULL * 1024 * 1024, count * 2, ae);
+    auto db = DB::create(256ULL * 1024 * 1024, count * 2, ae);
     if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
 
     std::vector<std::string> keys;
@@ -25,7 +31,18 @@ void bench_hyperion(int count) {
     }
     auto end = Clock::now();
     double dur = std::chrono::duration<double, std::nano>(end - start).count();
-    std::cout << "[Hyperion] Insert: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+    std::cout << label << " Insert: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+
+    // OVERWRITE BENCHMARK (same-size values: in-place path)
+    std::string val2 = val;
+    val2[0] = 'P';
+    start = Clock::now();
+    for(const auto& k : keys) {
+        db.put(k, val2);
+    }
+    end = Clock::now();
+    dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " Update: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
 
     // READ BENCHMARK
     std::string out;
@@ -35,7 +52,217 @@ void bench_hyperion(int count) {
     }
     end = Clock::now();
     dur = std::chrono::duration<double, std::nano>(end - start).count();
-    std::cout << "[Hyperion] Read  : " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+    std::cout << label << " Read  : " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+
+    // CALLER-BUFFER READ BENCHMARK
+    char buf[128];
+    std::size_t len = 0;
+    start = Clock::now();
+    for(const auto& k : keys) {
+        db.get(std::string_view(k), std::span<char>(buf), len);
+    }
+    end = Clock::now();
+    dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " Buffer: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+
+    // ZERO-COPY READ BENCHMARK
+    ValueView view;
+    std::size_t bytes = 0;
+    start = Clock::now();
+    for(const auto& k : keys) {
+        if (db.get_view(k, view) == Status::OK) bytes += view.value.size();
+    }
+    end = Clock::now();
+    dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " View  : " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op" << (bytes == 0 ? " (empty)" : "") << "\n";
+}
+
+template <typename DB>
+void bench_multi_get(const char* label, int count) {
+    ArenaError ae;
+    auto db = DB::create(256ULL * 1024 * 1024, count * 2, ae);
+    if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for(int i=0; i<count; ++i) keys.push_back("key:" + std::to_string(i));
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+    for(const auto& k : keys) db.put(k, val);
+
+    // Random access order defeats the hardware prefetcher, exposing raw miss latency.
+    std::vector<std::string_view> order(keys.begin(), keys.end());
+    std::mt19937 rng(7);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    ValueView view;
+    std::size_t hits = 0;
+    auto start = Clock::now();
+    for(auto k : order) hits += (db.get_view(k, view) == Status::OK);
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " Serial: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+
+    const std::size_t batch = 256;
+    std::vector<ValueView> out(batch);
+    std::vector<Status> status(batch);
+    start = Clock::now();
+    for(std::size_t i = 0; i < order.size(); i += batch) {
+        std::size_t n = std::min(batch, order.size() - i);
+        hits += db.multi_get(std::span<const std::string_view>(order.data() + i, n), out, status);
+    }
+    end = Clock::now();
+    dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " Batch : " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op" << (hits == 0 ? " (empty)" : "") << "\n";
+}
+
+template <typename DB>
+void bench_write_batch(const char* label, int count) {
+    ArenaError ae;
+    auto db = DB::create(256ULL * 1024 * 1024, count * 2, ae);
+    if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for(int i=0; i<count; ++i) keys.push_back("key:" + std::to_string(i));
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+
+    const std::size_t chunk = 4096;
+    std::vector<KeyValue> batch;
+    batch.reserve(chunk);
+    auto start = Clock::now();
+    for(std::size_t i = 0; i < keys.size(); i += chunk) {
+        batch.clear();
+        for(std::size_t j = i; j < std::min(keys.size(), i + chunk); ++j) batch.push_back({keys[j], val});
+        db.write_batch(batch);
+    }
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " BatchW: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+}
+
+/// \brief Cold-start load of the whole key set in one bulk_load() call.
+template <typename DB>
+void bench_bulk_load(const char* label, int count, std::uint32_t threads) {
+    ArenaError ae;
+    auto db = DB::create(256ULL * 1024 * 1024, count * 2, ae);
+    if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for(int i=0; i<count; ++i) keys.push_back("key:" + std::to_string(i));
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+    std::vector<KeyValue> dump;
+    dump.reserve(count);
+    for(const auto& k : keys) dump.push_back({k, val});
+
+    auto start = Clock::now();
+    db.bulk_load(dump, threads);
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << label << " Bulk" << std::setw(2) << threads << ": " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+}
+
+/// \brief Reads through a read-only attach_shared() mapping, as a reader process would.
+void bench_shared(int count) {
+    ArenaError ae;
+    auto db = Hyperion::create_shared("/hyperion_bench", 256ULL * 1024 * 1024, count * 2, ae);
+    if (ae != ArenaError::None) { std::cerr << "Hyperion shm alloc failed\n"; exit(1); }
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for(int i=0; i<count; ++i) keys.push_back("key:" + std::to_string(i));
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+    auto start = Clock::now();
+    for(const auto& k : keys) db.put(k, val);
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "[Shared  ] Insert: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+
+    auto reader = Hyperion::attach_shared("/hyperion_bench", ae);
+    if (reader == nullptr) { std::cerr << "Hyperion shm attach failed\n"; exit(1); }
+    std::string out;
+    start = Clock::now();
+    for(const auto& k : keys) reader->get(k, out);
+    end = Clock::now();
+    dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "[Shared  ] Read  : " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
+}
+
+/// \brief Aggregate put throughput with one writer thread per shard (keys pre-partitioned).
+void bench_sharded(std::uint32_t shards, int count) {
+    ArenaError ae;
+    auto db = ShardedHyperion::create(shards, 256ULL * 1024 * 1024 / shards, count * 2 / shards, ae);
+    if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
+
+    std::vector<std::vector<std::string>> keys(shards);
+    for(int i=0; i<count; ++i) {
+        std::string k = "key:" + std::to_string(i);
+        keys[db.shard_of(k)].push_back(std::move(k));
+    }
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+
+    auto start = Clock::now();
+    std::vector<std::thread> writers;
+    for(std::uint32_t s=0; s<shards; ++s) {
+        writers.emplace_back([&db, &keys, &val, s] { for(const auto& k : keys[s]) db.put(k, val); });
+    }
+    for(auto& w : writers) w.join();
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "[Sharded " << shards << "] Insert: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op (aggregate)\n";
+}
+
+/// \brief End-to-end put throughput through the MPSC write queue (producers + drain).
+void bench_write_queue(int producers, int count) {
+    ArenaError ae;
+    auto db = Hyperion::create(256ULL * 1024 * 1024, count * 2, ae);
+    if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for(int i=0; i<count; ++i) keys.push_back("key:" + std::to_string(i));
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+
+    auto start = Clock::now();
+    {
+        WriteQueue q(db);
+        std::vector<std::thread> threads;
+        for(int p=0; p<producers; ++p) {
+            threads.emplace_back([&, p] { for(int i=p; i<count; i+=producers) q.post_put(keys[i], val); });
+        }
+        for(auto& t : threads) t.join();
+        q.flush();
+    }
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "[Queue   " << producers << "] Insert: " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op (aggregate)\n";
+}
+
+/// \brief Random-order point reads with the Arena and index on the requested page size.
+void bench_pages(PageMode pages, int count) {
+    ArenaError ae;
+    auto db = Hyperion::create(1024ULL * 1024 * 1024, count * 2, ae, ArenaMode::Monotonic, MemoryOptions{pages});
+    if (ae != ArenaError::None) { std::cerr << "Hyperion alloc failed\n"; exit(1); }
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for(int i=0; i<count; ++i) keys.push_back("key:" + std::to_string(i));
+    std::string val = "payload:64bytes_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+    for(const auto& k : keys) db.put(k, val);
+
+    std::vector<std::string_view> order(keys.begin(), keys.end());
+    std::mt19937 rng(11);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    ValueView view;
+    std::size_t hits = 0;
+    auto start = Clock::now();
+    for(auto k : order) hits += (db.get_view(k, view) == Status::OK);
+    auto end = Clock::now();
+    double dur = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "[Pages " << std::setw(3) << page_mode_name(pages) << "] Read  : " << std::fixed << std::setprecision(2) << (dur / count)
+              << " ns/op (arena " << page_mode_name(db.arena_page_mode()) << ", index " << page_mode_name(db.index_page_mode()) << ")"
+              << (hits == 0 ? " (empty)" : "") << "\n";
 }
 
 void bench_std(int count) {
@@ -67,10 +294,63 @@ void bench_std(int count) {
     std::cout << "[StdMap  ] Read  : " << std::fixed << std::setprecision(2) << (dur / count) << " ns/op\n";
 }
 
+template <typename H>
+void bench_hash(const char* label) {
+    // Hash throughput across key lengths; results are accumulated to defeat dead-code elimination.
+    const std::size_t lens[] = {8, 16, 32, 64, 128, 256};
+    const int iters = 2000000;
+    std::vector<std::uint8_t> buf(256 + 64);
+    for (std::size_t i = 0; i < buf.size(); ++i) buf[i] = static_cast<std::uint8_t>(i * 131 + 7);
+
+    std::cout << label;
+    std::uint32_t sink = 0;
+    for (std::size_t len : lens) {
+        auto start = Clock::now();
+        for (int i = 0; i < iters; ++i) {
+            // Slide the window so every call hashes different bytes.
+            sink += H::hash(buf.data() + (i & 63), len);
+        }
+        auto end = Clock::now();
+        double dur = std::chrono::duration<double, std::nano>(end - start).count();
+        std::cout << " " << std::setw(4) << len << "B:" << std::fixed << std::setprecision(2) << std::setw(7) << (dur / iters) << "ns";
+    }
+    std::cout << (sink == 0 ? " " : "") << "\n";
+}
+
 int main() {
     const int N = 1000000; 
     std::cout << "Benchmarking " << N << " operations (Payload: 64B)...\n";
-    bench_hyperion(N);
+    bench_hyperion<Hyperion>("[Hyperion]", N);
+    bench_write_batch<Hyperion>("[Hyperion]", N);
+    bench_bulk_load<Hyperion>("[Hyperion]", N, 1);
+    bench_bulk_load<Hyperion>("[Hyperion]", N, std::max(std::thread::hardware_concurrency(), 1u));
+    bench_hyperion<BasicHyperion<SwissIndex>>("[Swiss   ]", N);
+    bench_hyperion<BasicHyperion<BasicIndex<CompactSlot>>>("[Compact ]", N);
+    bench_hyperion<BasicHyperion<RobinHoodIndex>>("[RobinHd ]", N);
+    bench_hyperion<BasicHyperion<Index, MixHash>>("[MixHash ]", N);
     bench_std(N);
+
+    std::cout << "Random-order reads (multi_get batch of 256):\n";
+    bench_multi_get<Hyperion>("[Hyperion]", N);
+    bench_multi_get<BasicHyperion<SwissIndex>>("[Swiss   ]", N);
+
+    std::cout << "Page size (requested; achieved in parentheses):\n";
+    bench_pages(PageMode::Small, N);
+    bench_pages(PageMode::Transparent, N);
+    bench_pages(PageMode::Huge2M, N);
+
+    std::cout << "Shared memory (reader in a second, read-only mapping):\n";
+    bench_shared(N);
+
+    std::cout << "Multi-writer (one thread per shard):\n";
+    bench_sharded(1, N);
+    bench_sharded(4, N);
+    bench_write_queue(1, N);
+    bench_write_queue(4, N);
+
+    std::cout << "Hash policies (ns/hash by key length):\n";
+    bench_hash<Fnv1a>("[Fnv1a   ]");
+    bench_hash<MixHash>("[MixHash ]");
+    bench_hash<Crc32cHash>("[Crc32c  ]");
     return 0;
 }
\ No newline at end of file
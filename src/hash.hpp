@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__SSE4_2__)
+    #include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+#endif
+
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+    #define HYPERION_HW_CRC32C_X86 1
+#elif defined(__ARM_FEATURE_CRC32)
+    #define HYPERION_HW_CRC32C_ARM 1
+#endif
+
+// Hash Policies
+// -------------
+// Each policy exposes `static std::uint32_t hash(const std::uint8_t*, std::size_t)` and is
+// selected at compile time via BasicHyperion's HashT parameter. The top 8 bits become the
+// Slot hash_tag and the low bits select the home bucket, so both ends must be well mixed.
+
+/// \brief murmur3 fmix32 finalizer: full avalanche of a 32-bit value.
+/// \details Used to derive independent bits from an existing hash (e.g. shard selection).
+inline std::uint32_t hash_mix32(std::uint32_t h) {
+    h ^= h >> 16; h *= 0x85ebca6bu;
+    h ^= h >> 13; h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+/// \brief FNV-1a (32-bit). Byte-at-a-time; kept as the default for stable hash values.
+struct Fnv1a {
+    static std::uint32_t hash(const std::uint8_t* data, std::size_t len) {
+        std::uint32_t h = 2166136261u;
+        for(std::size_t i=0; i<len; ++i) {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+};
+
+/// \brief wyhash-style multiply-fold hash consuming 16 bytes per round.
+/// \details Each round is one 64x64->128 multiply whose halves are XOR-folded, giving full
+/// avalanche in both the high (tag) and low (bucket) bits. Short keys take a branch-light
+/// path of two overlapping loads.
+struct MixHash {
+    static std::uint32_t hash(const std::uint8_t* data, std::size_t len) {
+        const std::uint8_t* p = data;
+        std::size_t n = len;
+        std::uint64_t seed = P0 ^ len;
+
+        while (n > 16) {
+            seed = mum(load64(p) ^ P1, load64(p + 8) ^ seed);
+            p += 16; n -= 16;
+        }
+
+        std::uint64_t a = 0, b = 0;
+        if (n >= 8) {
+            // Overlapping head/tail loads cover 8..16 bytes without a byte loop.
+            a = load64(p); b = load64(p + n - 8);
+        } else if (n >= 4) {
+            a = load32(p); b = load32(p + n - 4);
+        } else if (n > 0) {
+            a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[n >> 1]) << 8) | p[n - 1];
+        }
+
+        std::uint64_t h = mum(a ^ P1, b ^ seed);
+        h = mum(h ^ P2, len ^ P1);
+        return static_cast<std::uint32_t>(h ^ (h >> 32));
+    }
+
+private:
+    static constexpr std::uint64_t P0 = 0xa0761d6478bd642full;
+    static constexpr std::uint64_t P1 = 0xe7037ed1a0b428dbull;
+    static constexpr std::uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+
+    static std::uint64_t load64(const std::uint8_t* p) { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+    static std::uint64_t load32(const std::uint8_t* p) { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+
+    static std::uint64_t mum(std::uint64_t a, std::uint64_t b) {
+        #if defined(__SIZEOF_INT128__)
+            __extension__ unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+            return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+        #elif defined(_MSC_VER) && defined(_M_X64)
+            std::uint64_t hi;
+            std::uint64_t lo = _umul128(a, b, &hi);
+            return lo ^ hi;
+        #else
+            std::uint64_t ha = a >> 32, la = a & 0xFFFFFFFFu, hb = b >> 32, lb = b & 0xFFFFFFFFu;
+            std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            std::uint64_t t = rl + (rm0 << 32), c = t < rl;
+            std::uint64_t lo = t + (rm1 << 32); c += lo < t;
+            std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+            return lo ^ hi;
+        #endif
+    }
+};
+
+/// \brief CRC32C (Castagnoli) with a final avalanche step.
+/// \details Uses the SSE4.2 `crc32` instruction (8 bytes/instruction) or ARMv8 CRC32C when
+/// available, else a table-driven software fallback with identical output. CRC alone is
+/// linear, so the hash_mix32 finalizer spreads entropy into the tag bits.
+struct Crc32cHash {
+    static std::uint32_t hash(const std::uint8_t* data, std::size_t len) {
+        const std::uint8_t* p = data;
+        std::size_t n = len;
+        std::uint32_t crc = 0xFFFFFFFFu;
+
+        #if defined(HYPERION_HW_CRC32C_X86) && (defined(__x86_64__) || defined(_M_X64))
+            std::uint64_t c64 = crc;
+            for (; n >= 8; p += 8, n -= 8) {
+                std::uint64_t v; std::memcpy(&v, p, 8);
+                c64 = _mm_crc32_u64(c64, v);
+            }
+            crc = static_cast<std::uint32_t>(c64);
+            for (; n > 0; ++p, --n) crc = _mm_crc32_u8(crc, *p);
+        #elif defined(HYPERION_HW_CRC32C_X86)
+            for (; n >= 4; p += 4, n -= 4) {
+                std::uint32_t v; std::memcpy(&v, p, 4);
+                crc = _mm_crc32_u32(crc, v);
+            }
+            for (; n > 0; ++p, --n) crc = _mm_crc32_u8(crc, *p);
+        #elif defined(HYPERION_HW_CRC32C_ARM)
+            for (; n >= 8; p += 8, n -= 8) {
+                std::uint64_t v; std::memcpy(&v, p, 8);
+                crc = __crc32cd(crc, v);
+            }
+            for (; n > 0; ++p, --n) crc = __crc32cb(crc, *p);
+        #else
+            for (; n > 0; ++p, --n) crc = TABLE[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+        #endif
+
+        return hash_mix32(~crc);
+    }
+
+private:
+    // Reflected Castagnoli polynomial, generated at compile time.
+    static constexpr std::array<std::uint32_t, 256> TABLE = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : (c >> 1);
+            t[i] = c;
+        }
+        return t;
+    }();
+};
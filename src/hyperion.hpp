@@ -3,113 +3,470 @@
 #include "arena.hpp"
 #include "seqlock.hpp"
 #include "index.hpp"
+#include "swiss_index.hpp"
+#include "robin_hood_index.hpp"
+#include "wal.hpp"
+#include "snapshot.hpp"
 #include <cstring>
+#include <atomic>
+#include <bit>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <span>
+#include <concepts>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 // Hard limits for Version 1 (simplifies alignment logic).
 constexpr std::size_t MAX_KEY = 255;
 constexpr std::size_t MAX_VAL = 65535;
 
-enum class Status { OK, KeyTooLong, ValTooLong, ArenaFull, NotFound };
+enum class Status { OK, KeyTooLong, ValTooLong, ArenaFull, NotFound, IndexFull, BufferTooSmall };
+
+/// \brief Arena reclamation policy, fixed at creation.
+/// \details Monotonic uses the whole Arena and never reclaims. Compacting splits it into two
+/// half-spaces and incrementally copies live entries out of the full one (see compact_step()),
+/// trading half the capacity for bounded memory under overwrite/delete churn.
+enum class ArenaMode { Monotonic, Compacting };
 
 /// \brief On-disk/In-Arena Header.
-/// \details Packed immediately before the Key and Value bytes.
+/// \details Packed immediately before the Key and Value bytes. Entries tile the Arena back to
+/// back (each padded to 8 bytes), so the region can be walked header by header. Entries no
+/// slot points at are garbage: superseded values, deleted keys, the filler a shrinking
+/// in-place overwrite leaves behind (klen FILLER, vlen covering the freed tail) and the delete
+/// records a file-backed engine logs (klen DELETED | key length, no value).
 struct alignas(8) EntryHeader {
+    static constexpr std::uint16_t KEY_MASK = 0x00FF; ///< Key length bits of klen (MAX_KEY).
+    static constexpr std::uint16_t FILLER = 0x4000;   ///< klen flag: freed tail, no key.
+    static constexpr std::uint16_t DELETED = 0x8000;  ///< klen flag: the key was deleted here.
+
     std::uint16_t klen;
     std::uint16_t vlen;
     std::uint32_t hash;
 };
 
+/// \brief Fixed-width key encoding for integral keys.
+/// \details Every integral type is widened to 64 bits (sign-extended if signed) before hashing,
+/// so an `int` lookup finds a key stored as `std::uint64_t`. The 8 native-endian bytes share the
+/// key space with byte/string keys.
+struct IntKey {
+    template <std::integral K>
+    explicit IntKey(K key) {
+        using Wide = std::conditional_t<std::is_signed_v<K>, std::int64_t, std::uint64_t>;
+        std::uint64_t v = static_cast<std::uint64_t>(static_cast<Wide>(key));
+        std::memcpy(bytes, &v, sizeof(v));
+    }
+
+    std::string_view view() const { return {bytes, sizeof(bytes)}; }
+
+    char bytes[8];
+};
+
+/// \brief Key with its hash precomputed, e.g. by a router that already hashed it to pick a shard.
+/// \details The hash must come from the engine's own HashT (see BasicHyperion::hashed()).
+struct HashedKey {
+    std::string_view key;
+    std::uint32_t hash;
+};
+
+/// \brief Key/Value pair for batched writes (BasicHyperion::write_batch).
+struct KeyValue {
+    std::string_view key;
+    std::string_view val;
+};
+
+/// \brief Zero-copy read result.
+/// \details `value` points directly into the Arena. The Arena is never unmapped while the engine
+/// lives, so the bytes stay readable; `version` is the lock version they were resolved at, for
+/// BasicHyperion::validate(). A later put may overwrite the bytes in place (and under
+/// ArenaMode::Compacting recycle them), so they are only meaningful while the view validates.
+struct ValueView {
+    std::string_view value;
+    StripeVersion version;
+};
+
 /// \brief Hyperion Storage Engine.
-/// \details Orchestrates the Arena (Storage), Index (Lookup), and SeqLock (Concurrency).
-class Hyperion {
+/// \details Orchestrates the Arena (Storage), Index (Lookup), and StripedSeqLock (Concurrency).
+/// Writes to one key only invalidate readers of keys in the same lock stripe.
+/// \tparam IndexT Lookup structure: BasicIndex (linear probing), BasicSwissIndex (SIMD group probing)
+///                or BasicRobinHoodIndex (tombstone-free), over either Slot or CompactSlot.
+/// \tparam HashT  Hash policy from hash.hpp: Fnv1a, MixHash or Crc32cHash.
+template <typename IndexT = Index, typename HashT = Fnv1a>
+class BasicHyperion {
 public:
     // Default constructor (Invalid state for RVO fallback).
-    Hyperion() = default;
+    BasicHyperion() = default;
 
     /// \brief Factory method for creating the DB instance.
     /// \details Uses RVO (Return Value Optimization) to construct the Move-Only members in-place.
-    static Hyperion create(std::size_t bytes, std::uint32_t slots, ArenaError& ae) {
-        Arena a = Arena::create(bytes, ae);
+    /// \param mem Page placement for both the Arena and the index (see arena_page_mode()).
+    static BasicHyperion create(std::size_t bytes, std::uint32_t slots, ArenaError& ae,
+                                ArenaMode mode = ArenaMode::Monotonic, const MemoryOptions& mem = {}) {
+        IndexT idx; 
+        idx.set_memory(mem);
+        idx.init(slots);
+        return create(bytes, std::move(idx), ae, mode, mem);
+    }
+
+    /// \brief Factory taking a pre-initialized index (e.g. Index with a custom max load factor).
+    /// \details `mem` applies to the Arena only; place the index with its own set_memory().
+    static BasicHyperion create(std::size_t bytes, IndexT&& idx, ArenaError& ae,
+                                ArenaMode mode = ArenaMode::Monotonic, const MemoryOptions& mem = {}) {
+        // Slots address 8-byte units; the slot's reference width bounds the Arena.
+        if ((bytes >> REF_SHIFT) >= IndexT::slot_type::OFF_TOMB) {
+            ae = ArenaError::TooLarge;
+            return BasicHyperion();
+        }
+        Arena a = Arena::create(bytes, ae, mem);
         if (ae != ArenaError::None) {
-            return Hyperion();
+            return BasicHyperion();
         }
         
-        Index idx; 
-        idx.init(slots);
-        
         // Move resources into the instance.
-        return Hyperion(std::move(a), std::move(idx));
+        return BasicHyperion(std::move(a), std::move(idx), mode);
+    }
+
+    /// \brief Factory for a file-backed engine whose entries survive restarts.
+    /// \details The Arena is the file at `path` (see Arena::open()). A new file starts empty; an
+    /// existing one, written by an engine of the same size, ArenaMode and HashT, is reopened and
+    /// its index rebuilt by one sequential walk of the entries, so a restarted process serves
+    /// reads without reloading from upstream. Writes reach the page cache with no syscall and
+    /// survive a process crash; call sync() to make them durable against an OS crash.
+    /// \param ae FileFailed/BadFile from Arena::open() or a format mismatch; IndexFull if the
+    ///           index cannot hold the file's keys. On error the engine must not be used.
+    static BasicHyperion open(const char* path, std::size_t bytes, std::uint32_t slots, ArenaError& ae,
+                              ArenaMode mode = ArenaMode::Monotonic, const MemoryOptions& mem = {}) {
+        IndexT idx;
+        idx.set_memory(mem);
+        idx.init(slots);
+        return open(path, bytes, std::move(idx), ae, mode, mem);
+    }
+
+    /// \brief File-backed factory taking a pre-initialized index (see create()).
+    static BasicHyperion open(const char* path, std::size_t bytes, IndexT&& idx, ArenaError& ae,
+                              ArenaMode mode = ArenaMode::Monotonic, const MemoryOptions& mem = {}) {
+        if ((bytes >> REF_SHIFT) >= IndexT::slot_type::OFF_TOMB) {
+            ae = ArenaError::TooLarge;
+            return BasicHyperion();
+        }
+        Arena a = Arena::open(path, bytes, ae, mem);
+        if (ae != ArenaError::None) {
+            return BasicHyperion();
+        }
+        return BasicHyperion(std::move(a), std::move(idx), mode, ae);
+    }
+
+    /// \brief Factory for the writer of an engine shared with other processes through the named
+    /// shared-memory object `name` (e.g. "/hyperion"; see Arena::create_shared()).
+    /// \details The object holds, by offset, everything a reader needs: the SeqLock counters, the
+    /// index arrays and the Arena. This process is the single writer and uses the engine as
+    /// usual; any number of processes attach_shared() and read it with no IPC, retrying only when
+    /// a write races them, exactly like local readers. The index has a fixed capacity of `slots`
+    /// (a table other processes map cannot be reallocated), so size it for the data set: puts
+    /// report IndexFull once it is full. The name is unlinked when the engine goes; attached
+    /// readers keep serving the last state they saw.
+    static BasicHyperion create_shared(const char* name, std::size_t bytes, std::uint32_t slots, ArenaError& ae,
+                                       ArenaMode mode = ArenaMode::Monotonic, const MemoryOptions& mem = {}) {
+        if ((bytes >> REF_SHIFT) >= IndexT::slot_type::OFF_TOMB) {
+            ae = ArenaError::TooLarge;
+            return BasicHyperion();
+        }
+        const std::size_t prefix = SHARED_TABLE - Arena::FILE_HEADER + IndexT::shared_bytes(slots);
+        Arena a = Arena::create_shared(name, prefix, bytes, ae, mem);
+        if (ae != ArenaError::None) {
+            return BasicHyperion();
+        }
+        return BasicHyperion(std::move(a), slots, mode, true);
+    }
+
+    /// \brief Factory for a reader process of an engine published by create_shared().
+    /// \details Maps the object read-only; only the const interface (get, get_view, get_with,
+    /// multi_get, validate) is reachable. The engine must use the same IndexT and HashT as the
+    /// writer. A writer that dies inside a write leaves its lock stripe odd, and readers of that
+    /// stripe spin until a new writer replaces the object.
+    /// \param ae FileFailed if no object is named `name`; BadFile if it is not yet published or was
+    ///           written by a different engine type.
+    /// \return nullptr on error.
+    static std::unique_ptr<const BasicHyperion> attach_shared(const char* name, ArenaError& ae) {
+        Arena a = Arena::attach_shared(name, ae);
+        if (ae != ArenaError::None) return nullptr;
+
+        const ArenaSharedHeader* h = a.shared();
+        const std::uint64_t format = h->meta[SHM_FORMAT].load(std::memory_order_relaxed);
+        const std::uint64_t slots = h->meta[SHM_SLOTS].load(std::memory_order_relaxed);
+        if ((format >> 32) != hash_probe() || (format & 0xFFFFFFFFu) > 2 || slots > UINT32_MAX ||
+            h->meta[SHM_INDEX].load(std::memory_order_relaxed) != shared_kind() ||
+            h->meta[SHM_TABLE].load(std::memory_order_relaxed) != SHARED_TABLE ||
+            h->prefix < SHARED_TABLE + IndexT::shared_bytes(static_cast<std::uint32_t>(slots))) {
+            ae = ArenaError::BadFile;
+            return nullptr;
+        }
+        const ArenaMode mode = (format & 0xFFFFFFFFu) == 2 ? ArenaMode::Compacting : ArenaMode::Monotonic;
+        return std::unique_ptr<const BasicHyperion>(new BasicHyperion(std::move(a), static_cast<std::uint32_t>(slots), mode, false));
     }
 
     /// \brief Thread-safe Put (Single Writer).
     /// \details 
-    /// 1. Computes hash.
-    /// 2. Allocates aligned memory in Arena.
-    /// 3. Writes Header + Key + Value.
-    /// 4. Updates Index within a SeqLock Write transaction.
-    Status put(const std::string& key, const std::string& val) {
+    /// 1. Takes the key hash (string overloads compute it via hashed()).
+    /// 2. If the key exists and the value fits its entry, overwrites it in place (no Arena growth).
+    /// 3. Otherwise allocates aligned memory in Arena.
+    /// 4. Writes Header + Key + Value.
+    /// 5. Updates Index within a SeqLock Write transaction (advancing any online resize).
+    /// 6. Appends the write to the attached WriteAheadLog, if any (see recover()).
+    Status put(HashedKey hk, std::string_view val) {
+        std::string_view key = hk.key;
         if (key.size() > MAX_KEY) return Status::KeyTooLong;
         if (val.size() > MAX_VAL) return Status::ValTooLong;
 
-        std::uint32_t h = Index::hash((const std::uint8_t*)key.data(), key.size());
-        std::uint8_t tag = static_cast<std::uint8_t>(h >> 24);
+        std::uint32_t h = hk.hash;
+        if (overwrite_in_place(h, key, val)) {
+            if (wal_) wal_->append(WalOp::Put, key, val);
+            return Status::OK;
+        }
 
-        // Calculate size aligned to 8 bytes to prevent unaligned access penalties.
-        std::uint32_t needed = static_cast<std::uint32_t>(sizeof(EntryHeader) + key.size() + val.size());
-        needed = (needed + 7) & ~7; 
-        
-        std::uint32_t offset;
-        if (arena_.alloc(needed, offset) != ArenaError::None) return Status::ArenaFull;
-
-        // Direct memory write (memcpy) to mapped region.
-        auto* ptr = arena_.ptr_at(offset);
-        auto* hdr = new (ptr) EntryHeader; // Placement new
-        hdr->klen = static_cast<std::uint16_t>(key.size());
-        hdr->vlen = static_cast<std::uint16_t>(val.size());
-        hdr->hash = h;
-        std::memcpy(ptr + sizeof(EntryHeader), key.data(), key.size());
-        std::memcpy(ptr + sizeof(EntryHeader) + key.size(), val.data(), val.size());
+        std::uint64_t offset;
+        if (!allocate(entry_size(key.size(), val.size()), offset)) return Status::ArenaFull;
+        write_entry(offset, h, key, val);
+        persist_end();
 
         // Publish to Index (Critical Section).
-        index_.write([&](Index& idx) {
-            auto eq = [&](const Slot& s) {
-                if (!s.is_valid()) return false;
-                auto* e = (EntryHeader*)arena_.ptr_at(s.offset);
-                // Verify full hash and length before memcmp to save cycles.
-                if (e->hash != h || e->klen != key.size()) return false;
-                return std::memcmp((std::uint8_t*)(e + 1), key.data(), key.size()) == 0;
-            };
-
-            auto [slot_idx, exists] = idx.find(h, key.size(), eq);
-            // Append-only logic: Always point to the new offset. Old data remains as garbage.
-            idx.update(slot_idx, tag, static_cast<std::uint8_t>(key.size()), static_cast<std::uint16_t>(val.size()), offset);
+        bool stored = true;
+        write_key(h, [&](IndexT& idx) {
+            stored = publish(idx, h, key, val.size(), offset);
         });
 
+        if (!stored) return Status::IndexFull;
+        if (wal_) wal_->append(WalOp::Put, key, val);
         return Status::OK;
     }
 
+    /// \brief Batched Put (Single Writer): one Arena allocation, one SeqLock write.
+    /// \details All entries are staged contiguously in the Arena first, then every index update
+    /// is published inside a single SeqLock transaction, so concurrent readers are invalidated
+    /// once per batch rather than once per key. Later duplicates within the batch win.
+    /// Readers spin for the duration of the publish; chunk very large loads accordingly.
+    /// \return KeyTooLong/ValTooLong/ArenaFull reject the whole batch before anything is
+    /// published. IndexFull means entries before the first failure were published.
+    Status write_batch(std::span<const KeyValue> entries) {
+        std::size_t total = 0;
+        for (const auto& kv : entries) {
+            if (kv.key.size() > MAX_KEY) return Status::KeyTooLong;
+            if (kv.val.size() > MAX_VAL) return Status::ValTooLong;
+            total += entry_size(kv.key.size(), kv.val.size());
+        }
+        if (entries.empty()) return Status::OK;
+
+        std::uint64_t base;
+        if (!allocate(total, base)) return Status::ArenaFull;
+
+        // Stage: sequential writes into the batch's region (no index traffic yet).
+        std::uint64_t offset = base;
+        for (const auto& kv : entries) {
+            write_entry(offset, HashT::hash((const std::uint8_t*)kv.key.data(), kv.key.size()), kv.key, kv.val);
+            offset += entry_size(kv.key.size(), kv.val.size());
+        }
+        persist_end();
+
+        // Publish: walk the staged region; the stored hash avoids rehashing.
+        std::size_t published = 0;
+        index_.write([&](IndexT& idx) {
+            std::uint64_t off = base;
+            for (const auto& kv : entries) {
+                auto* e = (const EntryHeader*)arena_.ptr_at(off);
+                if (!publish(idx, e->hash, kv.key, kv.val.size(), off)) return;
+                off += entry_size(kv.key.size(), kv.val.size());
+                ++published;
+            }
+        });
+
+        // Log only what was applied, as put() does, so recover() never resurrects a rejected entry.
+        if (wal_) {
+            for (const auto& kv : entries.first(published)) wal_->append(WalOp::Put, kv.key, kv.val);
+        }
+        return published == entries.size() ? Status::OK : Status::IndexFull;
+    }
+
+    /// Fewest entries per bulk_load() staging slice; smaller loads go through write_batch().
+    static constexpr std::size_t BULK_SLICE = 1u << 14;
+    /// Fewest index slots per bulk_load() build range.
+    static constexpr std::uint32_t BULK_RANGE = 64;
+
+    /// \brief Parallel bulk load (Single Writer), e.g. a cold start from a sorted or unsorted dump.
+    /// \details Same result as write_batch(), built with `threads` threads:
+    ///   1. The input is cut into contiguous slices whose Arena footprints are summed in parallel,
+    ///      so one allocation can hold them all in input order.
+    ///   2. Each thread hashes its slice and writes it into its part of the allocation, counting
+    ///      entries per home-slot range (the top bits of hash & mask()), then files the entry
+    ///      offsets by range.
+    ///   3. Inside one structural SeqLock write, threads claim whole ranges and insert their
+    ///      entries with find_in()/insert_in(), which never probe outside the range, so no two
+    ///      threads touch the same slot. Keys whose probe would cross into the next range (or
+    ///      all of them while a BasicIndex resize is in flight) are published serially at the end.
+    /// Readers spin until the whole build is published; load before serving, or in chunks.
+    /// Later duplicates win. The write-ahead log, if attached, receives every published entry once
+    /// the build is done.
+    /// \param threads Worker threads, capped at std::thread::hardware_concurrency() and at the
+    ///                number of slices or ranges; 0 uses the cap.
+    /// \return Same contract as write_batch().
+    Status bulk_load(std::span<const KeyValue> entries, std::uint32_t threads = 0) {
+        const std::size_t n = entries.size();
+        // Never more threads than cores: the build runs inside the structural write and readers spin.
+        const std::uint32_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = threads == 0 ? cores : std::min(threads, cores);
+        const auto slices = static_cast<std::uint32_t>(std::min<std::size_t>(threads, n / BULK_SLICE));
+        if (slices <= 1) return write_batch(entries);
+        auto slice = [&](std::uint32_t c) {
+            const std::size_t lo = n * c / slices, hi = n * (c + 1) / slices;
+            return entries.subspan(lo, hi - lo);
+        };
+
+        // 1. Footprint of each slice; at[c] becomes slice c's offset from the allocation base.
+        std::vector<std::uint64_t> at(slices + 1, 0);
+        std::vector<Status> rejected(slices, Status::OK);
+        parallel(slices, [&](std::uint32_t c) {
+            std::uint64_t bytes = 0;
+            for (const auto& kv : slice(c)) {
+                if (kv.key.size() > MAX_KEY) { rejected[c] = Status::KeyTooLong; return; }
+                if (kv.val.size() > MAX_VAL) { rejected[c] = Status::ValTooLong; return; }
+                bytes += entry_size(kv.key.size(), kv.val.size());
+            }
+            at[c + 1] = bytes;
+        });
+        for (Status st : rejected) {
+            if (st != Status::OK) return st;
+        }
+        for (std::uint32_t c = 0; c < slices; ++c) at[c + 1] += at[c];
+        std::uint64_t base;
+        if (!allocate(at[slices], base)) return Status::ArenaFull;
+
+        // Home-slot ranges: a power of two of them, several per thread to balance the build.
+        const IndexT& cidx = index_.peek();
+        const std::uint32_t mask = cidx.mask();
+        const std::uint32_t ranges = std::min(std::bit_ceil(threads * 8), std::max(cidx.cap() / BULK_RANGE, 1u));
+        const unsigned shift = static_cast<unsigned>(std::countr_zero(cidx.cap() / ranges));
+        auto range_of = [&](std::uint32_t h) { return (h & mask) >> shift; };
+
+        // 2. Stage each slice in place, counting its entries per range.
+        std::vector<std::size_t> pos(static_cast<std::size_t>(slices) * ranges, 0);
+        parallel(slices, [&](std::uint32_t c) {
+            std::size_t* count = &pos[static_cast<std::size_t>(c) * ranges];
+            std::uint64_t offset = base + at[c];
+            for (const auto& kv : slice(c)) {
+                const std::uint32_t h = HashT::hash((const std::uint8_t*)kv.key.data(), kv.key.size());
+                write_entry(offset, h, kv.key, kv.val);
+                ++count[range_of(h)];
+                offset += entry_size(kv.key.size(), kv.val.size());
+            }
+        });
+        persist_end();
+
+        // File the offsets range-major; within a range, slices (and so input order) stay in order.
+        std::vector<std::size_t> first(ranges + 1, 0);
+        std::size_t filed = 0;
+        for (std::uint32_t r = 0; r < ranges; ++r) {
+            first[r] = filed;
+            for (std::uint32_t c = 0; c < slices; ++c) {
+                std::size_t& p = pos[static_cast<std::size_t>(c) * ranges + r];
+                const std::size_t k = p;
+                p = filed;
+                filed += k;
+            }
+        }
+        first[ranges] = filed;
+        std::vector<std::uint64_t> order(n);
+        parallel(slices, [&](std::uint32_t c) {
+            std::size_t* p = &pos[static_cast<std::size_t>(c) * ranges];
+            for (std::uint64_t offset = base + at[c]; offset < base + at[c + 1];) {
+                auto* e = (const EntryHeader*)arena_.ptr_at(offset);
+                order[p[range_of(e->hash)]++] = offset;
+                offset += footprint(e);
+            }
+        });
+
+        // 3. Build range by range, then publish what did not fit its range.
+        struct Worker {
+            std::uint32_t added = 0;
+            std::uint64_t dead[2] = {0, 0};
+            std::vector<std::uint64_t> spill;
+        };
+        const std::uint32_t builders = std::min(threads, ranges);
+        std::vector<Worker> workers(builders);
+        std::atomic<std::uint32_t> next{0};
+        bool stored = true;
+        std::vector<std::uint64_t> lost;  // Spilled entries left unpublished once the index filled.
+        index_.write([&](IndexT& idx) {
+            parallel(builders, [&](std::uint32_t t) {
+                Worker& w = workers[t];
+                for (std::uint32_t r; (r = next.fetch_add(1, std::memory_order_relaxed)) < ranges;) {
+                    const std::uint32_t hi = (r + 1) << shift;
+                    for (std::size_t i = first[r]; i < first[r + 1]; ++i) {
+                        if (i + 8 < first[r + 1]) prefetch_line(arena_.ptr_at(order[i + 8]));
+                        const std::uint64_t offset = order[i];
+                        auto* e = (const EntryHeader*)arena_.ptr_at(offset);
+                        auto eq = [&](const auto& s) {
+                            auto* o = entry(s.offset);
+                            return o->hash == e->hash && o->klen == e->klen && std::memcmp(o + 1, e + 1, e->klen) == 0;
+                        };
+                        auto [slot_idx, exists] = idx.find_in(hi, e->hash, e->klen, eq);
+                        if (exists) {
+                            note_dead(offset_of(idx.at(slot_idx)), w.dead);
+                            idx.update(slot_idx, static_cast<std::uint8_t>(e->hash >> 24), static_cast<std::uint8_t>(e->klen), e->vlen, ref_of(offset));
+                        } else if (slot_idx != IndexT::NPOS) {
+                            idx.insert_in(slot_idx, e->hash, static_cast<std::uint8_t>(e->klen), e->vlen, ref_of(offset));
+                            ++w.added;
+                        } else {
+                            w.spill.push_back(offset);
+                        }
+                    }
+                }
+            });
+
+            std::uint32_t added = 0;
+            for (const Worker& w : workers) {
+                added += w.added;
+                gc_.dead[0] += w.dead[0];
+                gc_.dead[1] += w.dead[1];
+            }
+            idx.bulk_done(added);
+            for (const Worker& w : workers) {
+                for (std::uint64_t offset : w.spill) {
+                    auto* e = (const EntryHeader*)arena_.ptr_at(offset);
+                    if (stored && !publish(idx, e->hash, std::string_view((const char*)(e + 1), e->klen), e->vlen, offset)) stored = false;
+                    if (!stored) lost.push_back(offset);
+                }
+            }
+        });
+
+        // Log what was published, in input order (staged offsets follow it).
+        if (wal_) {
+            std::sort(lost.begin(), lost.end());
+            std::uint64_t offset = base;
+            for (const auto& kv : entries) {
+                if (!std::binary_search(lost.begin(), lost.end(), offset)) wal_->append(WalOp::Put, kv.key, kv.val);
+                offset += entry_size(kv.key.size(), kv.val.size());
+            }
+        }
+
+        return stored ? Status::OK : Status::IndexFull;
+    }
+
     /// \brief Lock-free Get (Multi-Reader).
     /// \details Uses SeqLock optimistic reading. Retry loop handles concurrent writes.
-    Status get(const std::string& key, std::string& out_val) const {
-        std::uint32_t h = Index::hash((const std::uint8_t*)key.data(), key.size());
+    Status get(HashedKey hk, std::string& out_val) const {
+        std::string_view key = hk.key;
+        std::uint32_t h = hk.hash;
         
-        bool found = index_.read([&](const Index& idx) {
-            auto eq = [&](const Slot& s) {
-                if (!s.is_valid()) return false;
-                auto* e = (EntryHeader*)arena_.ptr_at(s.offset);
-                if (e->hash != h || e->klen != key.size()) return false;
-                return std::memcmp((std::uint8_t*)(e + 1), key.data(), key.size()) == 0;
-            };
-
-            auto [slot_idx, exists] = idx.find(h, key.size(), eq);
-            if (exists) {
-                const Slot& s = idx.at(slot_idx);
-                auto* e = (EntryHeader*)arena_.ptr_at(s.offset);
-                const char* vptr = (const char*)e + sizeof(EntryHeader) + e->klen;
-                // Copy out to string. For true zero-copy, return a std::string_view (requires lifecycle management).
-                out_val.assign(vptr, e->vlen);
+        bool found = index_.read(h, [&](const IndexT& idx) {
+            const EntryHeader* e = lookup(idx, h, key);
+            if (e != nullptr) {
+                // Copy out to string. For zero-copy, use get_view().
+                out_val.assign(value_of(e), e->vlen);
                 return true;
             }
             return false;
@@ -118,35 +475,874 @@ public:
         return found ? Status::OK : Status::NotFound;
     }
 
+    /// \brief Allocation-free Get into a caller-owned buffer (Multi-Reader).
+    /// \param len Receives the value size. On BufferTooSmall it holds the size required.
+    Status get(HashedKey hk, std::span<char> buf, std::size_t& len) const {
+        std::string_view key = hk.key;
+        std::uint32_t h = hk.hash;
+
+        return index_.read(h, [&](const IndexT& idx) {
+            const EntryHeader* e = lookup(idx, h, key);
+            if (e == nullptr) return Status::NotFound;
+            len = e->vlen;
+            if (e->vlen > buf.size()) return Status::BufferTooSmall;
+            std::memcpy(buf.data(), value_of(e), e->vlen);
+            return Status::OK;
+        });
+    }
+
+    /// \brief Visitor Get: invokes fn(std::string_view) on the value bytes inside the read section.
+    /// \details Nothing is copied. fn runs speculatively and is re-invoked if a concurrent write
+    /// forces a retry, so it must tolerate repeats and defer side effects to after return.
+    template <typename Fn>
+    Status get_with(HashedKey hk, Fn&& fn) const {
+        std::string_view key = hk.key;
+        std::uint32_t h = hk.hash;
+
+        return index_.read(h, [&](const IndexT& idx) {
+            const EntryHeader* e = lookup(idx, h, key);
+            if (e == nullptr) return Status::NotFound;
+            fn(std::string_view(value_of(e), e->vlen));
+            return Status::OK;
+        });
+    }
+
+    /// \brief Zero-copy Get (Multi-Reader).
+    /// \details Resolves the key under a SeqLock read and returns a view into the Arena without
+    /// copying. The view is consistent at `out.version`; call validate(out) after consuming it
+    /// to confirm no write has intervened (i.e. the value is still current).
+    Status get_view(HashedKey hk, ValueView& out) const {
+        std::string_view key = hk.key;
+        std::uint32_t h = hk.hash;
+
+        for (;;) {
+            StripeVersion v = index_.read_begin(h);
+            const EntryHeader* e = lookup(index_.peek(), h, key);
+            // Capture the view before validating: both reads must sit inside the section.
+            std::string_view value = (e != nullptr) ? std::string_view(value_of(e), e->vlen) : std::string_view();
+            if (!index_.validate(v)) continue;
+
+            if (e == nullptr) return Status::NotFound;
+            out.value = value;
+            out.version = v;
+            return Status::OK;
+        }
+    }
+
+    /// Keys resolved per pipelined read section in multi_get().
+    static constexpr std::size_t MULTI_GET_BATCH = 32;
+
+    /// \brief Batched zero-copy Get with software prefetching (group prefetching).
+    /// \details Per batch of MULTI_GET_BATCH keys, inside one read section:
+    ///   1. Hash every key and prefetch its home index bucket.
+    ///   2. Locate each candidate slot by tag and prefetch its Arena entry.
+    ///   3. Resolve each key with the deep compare, now hitting warm lines.
+    /// Independent misses overlap instead of serializing (memory-level parallelism).
+    /// \param out    Receives a ValueView per key (unchanged where NotFound).
+    /// \param status Receives OK or NotFound per key. Both spans must be at least keys.size().
+    /// \return Number of keys found.
+    std::size_t multi_get(std::span<const std::string_view> keys, std::span<ValueView> out, std::span<Status> status) const {
+        std::size_t found = 0;
+        HashedKey hks[MULTI_GET_BATCH];
+        for (std::size_t base = 0; base < keys.size(); base += MULTI_GET_BATCH) {
+            const std::size_t n = std::min(MULTI_GET_BATCH, keys.size() - base);
+            for (std::size_t i = 0; i < n; ++i) hks[i] = hashed(keys[base + i]);
+            found += multi_get(std::span<const HashedKey>(hks, n), out.subspan(base), status.subspan(base));
+        }
+        return found;
+    }
+
+    /// \brief multi_get() over keys hashed by the caller (see hashed()).
+    std::size_t multi_get(std::span<const HashedKey> keys, std::span<ValueView> out, std::span<Status> status) const {
+        std::size_t found = 0;
+        std::uint32_t hs[MULTI_GET_BATCH];
+        StripeVersion vs[MULTI_GET_BATCH];
+
+        for (std::size_t base = 0; base < keys.size(); base += MULTI_GET_BATCH) {
+            const std::size_t n = std::min(MULTI_GET_BATCH, keys.size() - base);
+            for (std::size_t i = 0; i < n; ++i) hs[i] = keys[base + i].hash;
+
+            for (;;) {
+                for (std::size_t i = 0; i < n; ++i) vs[i] = index_.read_begin(hs[i]);
+                const IndexT& idx = index_.peek();
+
+                // Stage 1: index lines.
+                for (std::size_t i = 0; i < n; ++i) idx.prefetch(hs[i]);
+
+                // Stage 2: arena lines of the first tag/length candidate.
+                // The offset is loaded once and range-checked as in lookup(): a concurrent writer may
+                // tombstone the slot between the tag match and the read.
+                auto first_live = [&](const auto& s) {
+                    using Ref = typename IndexT::slot_type::offset_type;
+                    const Ref ref = *static_cast<const volatile Ref*>(&s.offset);
+                    if (ref >= IndexT::slot_type::OFF_TOMB) return false;
+                    prefetch_line(entry(ref));
+                    return true;
+                };
+                for (std::size_t i = 0; i < n; ++i) idx.find(hs[i], keys[base + i].key.size(), first_live);
+
+                // Stage 3: resolve.
+                std::size_t batch_found = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    const EntryHeader* e = lookup(idx, hs[i], keys[base + i].key);
+                    if (e != nullptr) {
+                        out[base + i] = ValueView{std::string_view(value_of(e), e->vlen), vs[i]};
+                        status[base + i] = Status::OK;
+                        ++batch_found;
+                    } else {
+                        status[base + i] = Status::NotFound;
+                    }
+                }
+
+                bool consistent = true;
+                for (std::size_t i = 0; i < n; ++i) consistent &= index_.validate(vs[i]);
+                if (consistent) {
+                    found += batch_found;
+                    break;
+                }
+            }
+        }
+        return found;
+    }
+
+    /// \brief Returns true if the view's value lies in this engine's Arena, i.e. this engine resolved it.
+    bool owns(const ValueView& view) const {
+        const auto p = reinterpret_cast<std::uintptr_t>(view.value.data());
+        const auto base = reinterpret_cast<std::uintptr_t>(arena_.ptr_at(0));
+        return p >= base && p - base < arena_.size();
+    }
+
+    /// \brief Returns true if no write to the key's stripe (or structural write) has been
+    /// published since the view was resolved.
+    bool validate(const ValueView& view) const {
+        return index_.validate(view.version);
+    }
+
     /// \brief Logical Delete.
-    /// \details Marks the index slot as a Tombstone. Does not reclaim Arena memory.
-    Status del(const std::string& key) {
-        std::uint32_t h = Index::hash((const std::uint8_t*)key.data(), key.size());
+    /// \details Marks the index slot as a Tombstone. Arena memory is reclaimed only by compaction.
+    /// A file-backed engine first appends a delete record, so a restart does not resurrect the
+    /// key; it returns ArenaFull (and deletes nothing) if the record does not fit.
+    Status del(HashedKey hk) {
+        std::string_view key = hk.key;
+        std::uint32_t h = hk.hash;
         bool found = false;
+
+        if (arena_.file() != nullptr) {
+            if (lookup(index_.peek(), h, key) == nullptr) return Status::NotFound;
+            std::uint64_t offset;
+            if (!allocate(entry_size(key.size(), 0), offset)) return Status::ArenaFull;
+            write_entry(offset, h, key, {}, EntryHeader::DELETED);
+            note_dead(offset);
+            persist_end();
+        }
         
-        index_.write([&](Index& idx) {
-             auto eq = [&](const Slot& s) {
-                if (!s.is_valid()) return false;
-                auto* e = (EntryHeader*)arena_.ptr_at(s.offset);
-                return (e->hash == h && e->klen == key.size() &&
-                       std::memcmp((std::uint8_t*)(e + 1), key.data(), key.size()) == 0);
-            };
-
-            auto [slot_idx, exists] = idx.find(h, key.size(), eq);
-            if (exists) {
-                idx.at(slot_idx).make_tombstone();
-                found = true;
-            }
+        write_key(h, [&](IndexT& idx) {
+            found = erase(idx, h, key);
         });
         
+        if (found && wal_) wal_->append(WalOp::Del, key, {});
         return found ? Status::OK : Status::NotFound;
     }
 
+    /// Entries examined per compaction step (bounds the work added to a single put).
+    static constexpr std::uint32_t COMPACT_STEP = 64;
+
+    /// \brief Advances Arena compaction by one bounded step (Single Writer).
+    /// \details No-op under ArenaMode::Monotonic. Starts a cycle once the active half-space is
+    /// at least half full and at least half of it is dead (overwritten or deleted), then:
+    ///   1. Examines up to COMPACT_STEP entries of the old half-space, copying live ones into
+    ///      the active half-space outside any lock.
+    ///   2. Remaps their index offsets in one structural SeqLock write (readers retry).
+    ///   3. After the last entry, bumps the lock once more and returns the old half-space's
+    ///      pages to the OS; it becomes the target of the next cycle.
+    /// put/write_batch call this before allocating, so a cycle completes as writes proceed.
+    /// Compaction is held while a snapshot is running (see snapshot()).
+    /// \return true while a cycle is in progress.
+    bool compact_step() {
+        if (!gc_.enabled) return false;
+        if (pinned()) return gc_.active;
+        if (!gc_.active) {
+            std::uint64_t used = arena_.offset() - space_begin(gc_.space);
+            std::uint64_t span = space_end(gc_.space) - space_begin(gc_.space);
+            if (used < span / 2 || gc_.dead[gc_.space] < used / 2) return false;
+            begin_cycle();
+        }
+        evacuate();
+        return gc_.active;
+    }
+
+    /// \brief Runs a full compaction cycle to completion if there is anything to reclaim (Single Writer).
+    void compact() {
+        if (!gc_.enabled || pinned()) return;
+        if (!gc_.active) {
+            if (gc_.dead[gc_.space] == 0) return;
+            begin_cycle();
+        }
+        while (gc_.active && evacuate()) {}
+    }
+
+    /// \brief Arena bytes currently allocated, including dead entries not yet reclaimed (Single Writer).
+    std::size_t arena_used() const {
+        std::size_t used = arena_.offset() - space_begin(gc_.space);
+        if (gc_.active) used += gc_.scan_end - space_begin(gc_.space ^ 1);
+        return used;
+    }
+
+    /// \brief Page size the OS granted for the Arena (may be below the requested mode).
+    PageMode arena_page_mode() const { return arena_.page_mode(); }
+
+    /// \brief Page size backing the index slot array.
+    PageMode index_page_mode() const { return index_.peek().page_mode(); }
+
+    /// \brief True if MemoryOptions::lock pinned both the Arena and the index.
+    /// \details False when the OS refused the lock (e.g. RLIMIT_MEMLOCK); memory is still prefaulted.
+    bool memory_locked() const { return arena_.locked() && index_.peek().locked(); }
+
+    /// \brief Replays a write-ahead log into the engine, then logs every later write to it (Single Writer).
+    /// \details Records are re-applied in order with put/del at sequential read speed; a torn
+    /// tail is dropped (see WriteAheadLog::replay()). From then on every successful put,
+    /// write_batch and del appends a record before returning, and the log's WalSync policy
+    /// decides when groups of them are fsynced. The log must outlive the engine's writes.
+    /// \param records Receives the number of records replayed.
+    /// \return ApplyFailed if a record could not be applied (ArenaFull/IndexFull): the engine holds
+    /// the records before it, nothing after, and the log is not attached. Recover into a larger engine.
+    WalError recover(WriteAheadLog& wal, std::uint64_t& records) {
+        wal_ = nullptr;
+        bool applied = true;
+        WalError err = wal.replay([&](WalOp op, std::string_view key, std::string_view val) {
+            if (!applied) return;
+            // A delete whose key is already gone is a no-op, not a failure.
+            const Status st = op == WalOp::Put ? put(key, val) : del(key);
+            applied = st == Status::OK || st == Status::NotFound;
+        }, records);
+        if (err == WalError::None && !applied) err = WalError::ApplyFailed;
+        if (err == WalError::None) wal_ = &wal;
+        return err;
+    }
+
+    /// \brief True if the engine was created by open() (its Arena is a file).
+    bool persistent() const { return arena_.file() != nullptr; }
+
+    /// \brief Flushes a file-backed engine's Arena to disk and waits (Single Writer).
+    /// \details Entries written before the call survive an OS crash or power loss.
+    /// \return false on I/O failure or for an anonymous engine.
+    bool sync() const { return arena_.sync(arena_.size()); }
+
+    /// \brief NUMA node holding both the Arena and the index, -1 if either is unbound.
+    std::int32_t numa_node() const {
+        std::int32_t n = arena_.numa_node();
+        return n == index_.peek().numa_node() ? n : -1;
+    }
+
+    /// \brief Starts writing a point-in-time snapshot of every live entry to `path` (Single Writer).
+    /// \details Captures the Arena extent written so far and streams the entries that are live
+    /// now to the file on a background thread (see Snapshot), while this thread keeps serving
+    /// put/write_batch/del. Until the snapshot is done, overwrites of entries it covers append
+    /// instead of rewriting in place, and compaction is held, so under ArenaMode::Compacting a
+    /// half-space that fills meanwhile reports ArenaFull. The file replaces `path` only once
+    /// complete; load it with restore().
+    /// \return Busy if a snapshot is still running; OpenFailed if the file cannot be created.
+    SnapshotError snapshot(const char* path, const SnapshotOptions& opts = {}) {
+        if (pinned()) return SnapshotError::Busy;
+        SnapshotRange ranges[2] = {{space_begin(gc_.space), arena_.offset()}, {0, 0}};
+        std::size_t n = 1;
+        if (gc_.active) ranges[n++] = {space_begin(gc_.space ^ 1), gc_.scan_end};
+
+        SnapshotError err;
+        snap_ = Snapshot::start(path, hash_probe(), std::span<const SnapshotRange>(ranges, n), opts, err,
+                                [this](Snapshot& s) { stream(s); });
+        return err;
+    }
+
+    /// \brief True while a snapshot is being written (Single Writer). Releases a finished one.
+    bool snapshot_running() { return pinned(); }
+
+    /// \brief Waits for the running snapshot, if any, and returns the outcome of the last one (Single Writer).
+    SnapshotError snapshot_wait() {
+        if (snap_) {
+            snap_result_ = snap_->wait();
+            snap_.reset();
+        }
+        return snap_result_;
+    }
+
+    /// Snapshot bytes restore() hands to each bulk_load().
+    static constexpr std::size_t RESTORE_BATCH = 64u << 20;
+
+    /// \brief Loads a snapshot file written by snapshot() (Single Writer).
+    /// \details Blocks are read sequentially and handed to bulk_load() in batches of about
+    /// RESTORE_BATCH bytes. A snapshot holds one entry per key, so this restores exactly the
+    /// keys and values live when it was taken. Restore into an empty engine before serving,
+    /// then recover() the write-ahead log, if any.
+    /// \param entries Receives the number of entries restored.
+    /// \param threads Passed to bulk_load().
+    /// \return BadFile if the file is incomplete or corrupt; Full if the engine ran out of Arena
+    /// or index space. Either way the engine holds a partial restore and should be discarded.
+    SnapshotError restore(const char* path, std::uint64_t& entries, std::uint32_t threads = 0) {
+        entries = 0;
+        SnapshotHeader hdr{};
+        std::vector<char> batch;
+        std::vector<KeyValue> kvs;
+        auto flush = [&] {
+            const Status st = bulk_load(kvs, threads);
+            if (st == Status::OK) entries += kvs.size();
+            kvs.clear();
+            batch.clear();
+            return st == Status::OK ? SnapshotError::None : SnapshotError::Full;
+        };
+
+        SnapshotError err = Snapshot::load(path, hdr, [&](std::string_view block) {
+            // The batch never reallocates: kvs point into it.
+            if (batch.capacity() == 0) batch.reserve(std::max<std::size_t>(RESTORE_BATCH, hdr.block_bytes));
+            if (batch.size() + block.size() > batch.capacity()) {
+                SnapshotError fe = flush();
+                if (fe != SnapshotError::None) return fe;
+            }
+            const char* p = batch.data() + batch.size();
+            batch.insert(batch.end(), block.begin(), block.end());
+
+            for (std::size_t at = 0; at < block.size();) {
+                EntryHeader e;
+                if (block.size() - at < sizeof(e)) return SnapshotError::BadFile;
+                std::memcpy(&e, p + at, sizeof(e));
+                const std::uint32_t size = footprint(&e);
+                if ((e.klen & ~EntryHeader::KEY_MASK) != 0 || size > block.size() - at) return SnapshotError::BadFile;
+                const char* key = p + at + sizeof(e);
+                kvs.push_back({std::string_view(key, e.klen), std::string_view(key + e.klen, e.vlen)});
+                at += size;
+            }
+            return SnapshotError::None;
+        });
+        if (err == SnapshotError::None && !kvs.empty()) err = flush();
+        if (err == SnapshotError::None && entries != hdr.entries) err = SnapshotError::BadFile;
+        return err;
+    }
+
+    /// \brief Hashes a key with the engine's HashT, for the HashedKey overloads.
+    static HashedKey hashed(std::string_view key) {
+        return {key, HashT::hash((const std::uint8_t*)key.data(), key.size())};
+    }
+
+    // String Key Overloads (hash computed here).
+    Status put(std::string_view key, std::string_view val) { return put(hashed(key), val); }
+    Status get(std::string_view key, std::string& out_val) const { return get(hashed(key), out_val); }
+    Status get(std::string_view key, std::span<char> buf, std::size_t& len) const { return get(hashed(key), buf, len); }
+    template <typename Fn>
+    Status get_with(std::string_view key, Fn&& fn) const { return get_with(hashed(key), std::forward<Fn>(fn)); }
+    Status get_view(std::string_view key, ValueView& out) const { return get_view(hashed(key), out); }
+    Status del(std::string_view key) { return del(hashed(key)); }
+
+    // Binary Key/Value Overloads (std::byte spans, e.g. straight out of a network buffer).
+    Status put(std::span<const std::byte> key, std::span<const std::byte> val) {
+        return put(as_chars(key), as_chars(val));
+    }
+    Status get(std::span<const std::byte> key, std::span<std::byte> buf, std::size_t& len) const {
+        return get(as_chars(key), std::span<char>((char*)buf.data(), buf.size()), len);
+    }
+    Status del(std::span<const std::byte> key) {
+        return del(as_chars(key));
+    }
+
+    // Integral Key Overloads (encoded via IntKey; no allocation).
+    template <std::integral K>
+    Status put(K key, std::string_view val) { return put(IntKey(key).view(), val); }
+    template <std::integral K>
+    Status get(K key, std::string& out_val) const { return get(IntKey(key).view(), out_val); }
+    template <std::integral K>
+    Status get(K key, std::span<char> buf, std::size_t& len) const { return get(IntKey(key).view(), buf, len); }
+    template <std::integral K, typename Fn>
+    Status get_with(K key, Fn&& fn) const { return get_with(IntKey(key).view(), std::forward<Fn>(fn)); }
+    template <std::integral K>
+    Status get_view(K key, ValueView& out) const { return get_view(IntKey(key).view(), out); }
+    template <std::integral K>
+    Status del(K key) { return del(IntKey(key).view()); }
+
 private:
+    /// \brief Arena footprint of an entry, aligned to 8 bytes to prevent unaligned access penalties.
+    static std::uint32_t entry_size(std::size_t klen, std::size_t vlen) {
+        std::uint32_t needed = static_cast<std::uint32_t>(sizeof(EntryHeader) + klen + vlen);
+        return (needed + 7) & ~7u;
+    }
+
+    /// \brief Arena footprint of an entry already in the Arena (flag bits excluded).
+    static std::uint32_t footprint(const EntryHeader* e) {
+        return entry_size(e->klen & EntryHeader::KEY_MASK, e->vlen);
+    }
+
+    /// \brief Writes Header + Key + Value at offset (direct memcpy to the mapped region).
+    /// \param flags EntryHeader klen flag bits (delete records).
+    void write_entry(std::uint64_t offset, std::uint32_t h, std::string_view key, std::string_view val,
+                     std::uint16_t flags = 0) {
+        auto* ptr = arena_.ptr_at(offset);
+        auto* hdr = new (ptr) EntryHeader; // Placement new
+        hdr->klen = static_cast<std::uint16_t>(key.size() | flags);
+        hdr->vlen = static_cast<std::uint16_t>(val.size());
+        hdr->hash = h;
+        std::memcpy(ptr + sizeof(EntryHeader), key.data(), key.size());
+        std::memcpy(ptr + sizeof(EntryHeader) + key.size(), val.data(), val.size());
+    }
+
+    /// \brief Rewrites an existing entry's value if the new value fits the entry's footprint.
+    /// \details The value bytes, header length and slot are rewritten inside one keyed SeqLock
+    /// write: only readers of this key's stripe retry, and no other slot moves, so this is
+    /// keyed on every index. A shorter value hands the freed tail back as a filler entry.
+    /// \return false if the key is absent, the value needs a larger entry or a snapshot is reading it.
+    bool overwrite_in_place(std::uint32_t h, std::string_view key, std::string_view val) {
+        auto eq = [&](const auto& s) {
+            if (!s.is_valid()) return false;
+            auto* e = entry(s.offset);
+            if (e->hash != h || e->klen != key.size()) return false;
+            return std::memcmp((std::uint8_t*)(e + 1), key.data(), key.size()) == 0;
+        };
+
+        // Probing outside the lock is safe on the writer thread: nothing else mutates the index.
+        auto [slot_idx, exists] = index_.peek().find(h, key.size(), eq);
+        if (!exists) return false;
+
+        const std::uint64_t offset = offset_of(index_.peek().at(slot_idx));
+        // A running snapshot reads these bytes: copy on write by appending instead.
+        if (pinned() && snap_->covers(offset)) return false;
+        auto* e = (EntryHeader*)arena_.ptr_at(offset);
+        const std::uint32_t have = entry_size(e->klen, e->vlen);
+        const std::uint32_t need = entry_size(key.size(), val.size());
+        if (need > have) return false;
+
+        index_.write(h, [&](IndexT& idx) {
+            if (need < have) {
+                auto* filler = new (arena_.ptr_at(offset + need)) EntryHeader;
+                filler->klen = EntryHeader::FILLER;
+                filler->vlen = static_cast<std::uint16_t>(have - need - sizeof(EntryHeader));
+                filler->hash = 0;
+            }
+            std::memcpy((std::uint8_t*)(e + 1) + key.size(), val.data(), val.size());
+            e->vlen = static_cast<std::uint16_t>(val.size());
+            idx.update(slot_idx, static_cast<std::uint8_t>(h >> 24), static_cast<std::uint8_t>(key.size()), static_cast<std::uint16_t>(val.size()), ref_of(offset));
+        });
+        if (need < have) note_dead(offset + need);
+        return true;
+    }
+
+    /// \brief Keyed write if the index guarantees slot-local mutation, structural otherwise.
+    template <typename F>
+    void write_key(std::uint32_t h, F&& f) {
+        if (index_.peek().local_writes()) {
+            index_.write(h, std::forward<F>(f));
+        } else {
+            index_.write(std::forward<F>(f));
+        }
+    }
+
+    /// \brief Points the key's index slot at offset. Must run inside index_.write().
+    /// \return false if the index is full.
+    bool publish(IndexT& idx, std::uint32_t h, std::string_view key, std::size_t vlen, std::uint64_t offset) {
+        idx.migrate([&](const auto& s) { return entry(s.offset)->hash; });
+
+        auto eq = [&](const auto& s) {
+            if (!s.is_valid()) return false;
+            auto* e = entry(s.offset);
+            // Verify full hash and length before memcmp to save cycles.
+            if (e->hash != h || e->klen != key.size()) return false;
+            return std::memcmp((std::uint8_t*)(e + 1), key.data(), key.size()) == 0;
+        };
+
+        auto [slot_idx, exists] = idx.find(h, key.size(), eq);
+        // Append-only logic: Always point to the new offset. Old data remains as garbage.
+        if (exists) {
+            note_dead(offset_of(idx.at(slot_idx)));
+            idx.update(slot_idx, static_cast<std::uint8_t>(h >> 24), static_cast<std::uint8_t>(key.size()), static_cast<std::uint16_t>(vlen), ref_of(offset));
+            return true;
+        }
+        return idx.insert(slot_idx, h, static_cast<std::uint8_t>(key.size()), static_cast<std::uint16_t>(vlen), ref_of(offset));
+    }
+
+    /// \brief Tombstones the key's slot. Must run inside index_.write().
+    /// \return false if the key is absent.
+    bool erase(IndexT& idx, std::uint32_t h, std::string_view key) {
+        auto eq = [&](const auto& s) {
+            if (!s.is_valid()) return false;
+            auto* e = entry(s.offset);
+            return (e->hash == h && e->klen == key.size() &&
+                   std::memcmp((std::uint8_t*)(e + 1), key.data(), key.size()) == 0);
+        };
+
+        auto [slot_idx, exists] = idx.find(h, key.size(), eq);
+        if (!exists) return false;
+        note_dead(offset_of(idx.at(slot_idx)));
+        idx.erase(slot_idx);
+        return true;
+    }
+
+    /// \brief Runs fn(0) .. fn(n - 1) on n threads (fn(0) on the caller) and joins them.
+    template <typename Fn>
+    static void parallel(std::uint32_t n, Fn&& fn) {
+        std::vector<std::thread> pool;
+        pool.reserve(n - 1);
+        for (std::uint32_t i = 1; i < n; ++i) pool.emplace_back([&fn, i] { fn(i); });
+        fn(0);
+        for (auto& t : pool) t.join();
+    }
+
+    static std::string_view as_chars(std::span<const std::byte> b) {
+        return {(const char*)b.data(), b.size()};
+    }
+
+    /// \brief Resolves a key to its live entry, or nullptr. Speculative under SeqLock reads.
+    /// \details The slot offset is loaded exactly once: a racing delete may turn the slot into a
+    /// tombstone between two loads, and a sentinel offset must never be dereferenced.
+    const EntryHeader* lookup(const IndexT& idx, std::uint32_t h, std::string_view key) const {
+        const EntryHeader* hit = nullptr;
+        auto eq = [&](const auto& s) {
+            using Ref = typename IndexT::slot_type::offset_type;
+            const Ref ref = *static_cast<const volatile Ref*>(&s.offset);
+            if (ref >= IndexT::slot_type::OFF_TOMB) return false;
+            const EntryHeader* e = entry(ref);
+            if (e->hash != h || e->klen != key.size()) return false;
+            if (std::memcmp((const std::uint8_t*)(e + 1), key.data(), key.size()) != 0) return false;
+            hit = e;
+            return true;
+        };
+
+        idx.find(h, key.size(), eq);
+        return hit;
+    }
+
+    static const char* value_of(const EntryHeader* e) {
+        return (const char*)e + sizeof(EntryHeader) + e->klen;
+    }
+
+    /// \brief Half-space compaction state (writer-owned; see compact_step()).
+    struct Compactor {
+        bool enabled = false;
+        bool active = false;            // A cycle is evacuating the other half-space.
+        std::uint32_t space = 0;        // Half-space receiving allocations.
+        std::uint64_t half = 0;         // Boundary between half-space 0 and 1.
+        std::uint64_t scan = 0;         // Next entry to examine in the old half-space.
+        std::uint64_t scan_end = 0;     // End of the old half-space's entries.
+        std::uint64_t dead[2] = {0, 0}; // Bytes of overwritten/deleted entries per half-space.
+    };
+
+    /// \brief Move of one live entry, staged by evacuate() and published under the lock.
+    struct Relocation {
+        std::uint32_t slot;
+        std::uint64_t offset;
+        const EntryHeader* entry;
+    };
+
+    /// Entries are 8-byte aligned, so slots store Arena offsets in 8-byte units.
+    static constexpr unsigned REF_SHIFT = 3;
+
+    static std::uint64_t ref_of(std::uint64_t offset) { return offset >> REF_SHIFT; }
+    template <typename SlotT>
+    static std::uint64_t offset_of(const SlotT& s) { return static_cast<std::uint64_t>(s.offset) << REF_SHIFT; }
+    EntryHeader* entry(std::uint64_t ref) const { return (EntryHeader*)arena_.ptr_at(ref << REF_SHIFT); }
+
+    std::uint64_t space_begin(std::uint32_t s) const { return (s == 0) ? 8 : gc_.half; }
+    std::uint64_t space_end(std::uint32_t s) const { return (s == 0 && gc_.enabled) ? gc_.half : (arena_.size() & ~std::uint64_t(7)); }
+
+    /// \brief Allocates entry space, advancing compaction first (Single Writer).
+    /// \details If the active half-space is exhausted, finishes the running cycle and, if the
+    /// half-space holds dead entries, runs one more full cycle before giving up (at once while
+    /// a snapshot holds compaction).
+    bool allocate(std::uint64_t size, std::uint64_t& offset) {
+        if (gc_.enabled) compact_step();
+        if (arena_.alloc(size, offset) == ArenaError::None) return true;
+        if (!gc_.enabled || pinned()) return false;
+
+        while (gc_.active) {
+            if (!evacuate()) return false;
+        }
+        if (gc_.dead[gc_.space] == 0) return false;
+        compact();
+        return arena_.alloc(size, offset) == ArenaError::None;
+    }
+
+    /// \brief Accounts the entry at offset as garbage. Must run on the writer thread.
+    /// \details Called before the slot stops pointing at the entry, which lets a running
+    /// snapshot still count it as live (Snapshot::retire()).
+    void note_dead(std::uint64_t offset) { note_dead(offset, gc_.dead); }
+
+    /// \brief note_dead() into a caller-owned tally (bulk_load() workers fold theirs in after joining).
+    void note_dead(std::uint64_t offset, std::uint64_t (&dead)[2]) const {
+        if (snap_ && snap_->covers(offset)) snap_->retire(offset);
+        if (!gc_.enabled) return;
+        auto* e = (const EntryHeader*)arena_.ptr_at(offset);
+        dead[offset >= gc_.half] += footprint(e);
+    }
+
+    /// \brief Flips allocation to the empty half-space and starts evacuating the full one.
+    void begin_cycle() {
+        std::uint32_t from = gc_.space, to = from ^ 1;
+        gc_.scan = space_begin(from);
+        gc_.scan_end = arena_.offset();
+        gc_.space = to;
+        gc_.dead[to] = 0;
+        gc_.active = true;
+        arena_.reset(space_begin(to), space_end(to));
+
+        // The target's stale extent is forgotten before the cycle is recorded as started.
+        if (ArenaFileHeader* f = arena_.file()) {
+            f->meta[META_END0 + to].store(space_begin(to), std::memory_order_release);
+            f->meta[META_FROM_END].store(gc_.scan_end, std::memory_order_release);
+            f->meta[META_STATE].store(to | STATE_DRAINING, std::memory_order_release);
+        }
+    }
+
+    /// \brief One compaction step: copy up to COMPACT_STEP entries' live subset, then remap.
+    /// \return false if the active half-space cannot take the next live entry.
+    bool evacuate() {
+        Relocation moves[COMPACT_STEP];
+        std::uint32_t moved = 0;
+        bool room = true;
+
+        // Stage copies without the lock: the writer is the only thread mutating the index,
+        // and no reader can reach the destination bytes until the remap is published.
+        const IndexT& cidx = index_.peek();
+        for(std::uint32_t n=0; n<COMPACT_STEP && gc_.scan < gc_.scan_end; ++n) {
+            const std::uint64_t at = gc_.scan;
+            auto* e = (const EntryHeader*)arena_.ptr_at(at);
+            const std::uint32_t size = footprint(e);
+
+            // Live iff some slot still points at this exact entry.
+            const std::uint64_t ref = ref_of(at);
+            auto [slot_idx, live] = cidx.find(e->hash, e->klen, [ref](const auto& s) { return s.offset == ref; });
+            if (live) {
+                std::uint64_t dst;
+                if (arena_.alloc(size, dst) != ArenaError::None) { room = false; break; }
+                std::memcpy(arena_.ptr_at(dst), e, size);
+                moves[moved++] = {slot_idx, dst, e};
+            }
+            gc_.scan = at + size;
+        }
+        if (moved != 0) persist_end();
+
+        // Structural: a reader of any key may be holding an old offset of a moved one.
+        if (moved != 0) {
+            index_.write([&](IndexT& idx) {
+                for(std::uint32_t i=0; i<moved; ++i) {
+                    const EntryHeader* e = moves[i].entry;
+                    idx.update(moves[i].slot, static_cast<std::uint8_t>(e->hash >> 24), static_cast<std::uint8_t>(e->klen), e->vlen, ref_of(moves[i].offset));
+                }
+            });
+        }
+
+        if (room && gc_.scan == gc_.scan_end) {
+            // Invalidate every read section that might still dereference the old half-space
+            // (e.g. via a slot overwritten by a keyed write) before its pages are recycled.
+            index_.write([](IndexT&) {});
+            // Recorded before the discard: a restart must no longer replay the old half-space.
+            if (ArenaFileHeader* f = arena_.file()) f->meta[META_STATE].store(gc_.space, std::memory_order_release);
+            std::uint32_t from = gc_.space ^ 1;
+            arena_.discard(space_begin(from), space_end(from));
+            gc_.dead[from] = 0;
+            gc_.active = false;
+        }
+        return room;
+    }
+
+    /// \brief True while a snapshot reads the Arena (Single Writer); releases a finished one.
+    bool pinned() {
+        if (!snap_) return false;
+        if (!snap_->done()) return true;
+        snapshot_wait();
+        return false;
+    }
+
+    /// \brief Snapshot thread: passes every entry of the captured ranges that was live at the start.
+    /// \details The slot is checked before the retirement bit: the writer sets the bit before it
+    /// moves the slot, so an entry that misses both was already dead when the snapshot began.
+    void stream(Snapshot& s) const {
+        for (const SnapshotRange& r : s.ranges()) {
+            for (std::uint64_t at = r.begin; at < r.end;) {
+                auto* e = (const EntryHeader*)arena_.ptr_at(at);
+                const std::uint32_t size = footprint(e);
+                const bool data = (e->klen & (EntryHeader::FILLER | EntryHeader::DELETED)) == 0;
+                if (data && (referenced(e, at) || s.retired(at)) && !s.append(e, size)) return;
+                at += size;
+            }
+        }
+    }
+
+    /// \brief True if an index slot points at the entry at offset (any thread).
+    bool referenced(const EntryHeader* e, std::uint64_t offset) const {
+        using Ref = typename IndexT::slot_type::offset_type;
+        const std::uint64_t ref = ref_of(offset);
+        return index_.read(e->hash, [&](const IndexT& idx) {
+            return idx.find(e->hash, e->klen, [ref](const auto& s) {
+                return *static_cast<const volatile Ref*>(&s.offset) == ref;
+            }).second;
+        });
+    }
+
+    /// Words of ArenaFileHeader::meta used by a file-backed engine.
+    enum Meta : std::uint32_t {
+        META_FORMAT,   // format_word() of the engine that wrote the file (0 = new file).
+        META_STATE,    // Active half-space, | STATE_DRAINING while the other is being evacuated.
+        META_END0,     // Written extent of half-space 0 (the whole Arena when Monotonic).
+        META_END1,     // Written extent of half-space 1.
+        META_FROM_END, // End of the half-space being evacuated.
+    };
+    static constexpr std::uint64_t STATE_DRAINING = 2;
+
+    /// Words of ArenaSharedHeader::meta describing a shared-memory engine to attaching readers.
+    enum SharedMeta : std::uint32_t {
+        SHM_FORMAT, // format_word() of the writer.
+        SHM_INDEX,  // shared_kind() of the writer's index.
+        SHM_SLOTS,  // Slot count the index was laid out for.
+        SHM_TABLE,  // SHARED_TABLE of the writer's build.
+    };
+
+    /// Object offsets of the SeqLock counters and the index arrays of a shared-memory engine
+    /// (the ArenaSharedHeader occupies the first page).
+    static constexpr std::size_t SHARED_LOCK = Arena::FILE_HEADER;
+    static constexpr std::size_t SHARED_TABLE =
+        SHARED_LOCK + (StripedSeqLock<IndexT>::COUNTER_BYTES + Arena::FILE_HEADER - 1) / Arena::FILE_HEADER * Arena::FILE_HEADER;
+
+    /// \brief Identifies the index layout: its type and slot width.
+    static std::uint64_t shared_kind() {
+        return (std::uint64_t(IndexT::SHARED_KIND) << 32) | sizeof(typename IndexT::slot_type);
+    }
+
+    /// \brief An index over the arrays of a shared-memory Arena (see create_shared()).
+    static IndexT shared_index(const Arena& a, std::uint32_t slots, bool fresh) {
+        IndexT idx;
+        idx.init_shared(slots, reinterpret_cast<std::uint8_t*>(a.shared()) + SHARED_TABLE, fresh);
+        return idx;
+    }
+
+    /// \brief Identifies the hash policy: stored hashes are only reusable by an equal probe.
+    static std::uint64_t hash_probe() {
+        return HashT::hash((const std::uint8_t*)"hyperion", 8);
+    }
+
+    /// \brief Identifies files this engine can reopen: the hash policy (by a probe hash) and mode.
+    std::uint64_t format_word() const {
+        return (hash_probe() << 32) | (gc_.enabled ? 2u : 1u);
+    }
+
+    /// \brief Records the active half-space's written extent in the file (file-backed only).
+    /// \details Called once the entry bytes are in place, so a restart never replays a torn entry.
+    void persist_end() {
+        if (ArenaFileHeader* f = arena_.file()) {
+            f->meta[META_END0 + gc_.space].store(arena_.offset(), std::memory_order_release);
+        }
+    }
+
+    /// \brief Stamps a new file, or validates a reopened one and rebuilds the index from it.
+    /// \details Replays the half-space being evacuated (if a cycle was interrupted) and then the
+    /// active one, in write order: later entries for a key supersede earlier ones and delete
+    /// records drop it. Rebuilding runs before any reader exists, inside one structural write.
+    /// An interrupted compaction cycle resumes from the start of its old half-space.
+    ArenaError attach() {
+        ArenaFileHeader* f = arena_.file();
+        if (f->meta[META_FORMAT].load(std::memory_order_acquire) == 0) {
+            f->meta[META_END0].store(space_begin(0), std::memory_order_relaxed);
+            f->meta[META_END1].store(space_begin(1), std::memory_order_relaxed);
+            f->meta[META_STATE].store(0, std::memory_order_relaxed);
+            f->meta[META_FORMAT].store(format_word(), std::memory_order_release);
+            return ArenaError::None;
+        }
+        if (f->meta[META_FORMAT].load(std::memory_order_acquire) != format_word()) return ArenaError::BadFile;
+
+        const std::uint64_t state = f->meta[META_STATE].load(std::memory_order_acquire);
+        const std::uint32_t space = static_cast<std::uint32_t>(state & 1);
+        const bool draining = (state & STATE_DRAINING) != 0;
+        if (state > (STATE_DRAINING | 1) || (space != 0 && !gc_.enabled) || (draining && !gc_.enabled)) return ArenaError::BadFile;
+
+        auto in_space = [&](std::uint32_t s, std::uint64_t end) { return end >= space_begin(s) && end <= space_end(s); };
+        const std::uint32_t from = space ^ 1;
+        const std::uint64_t end = f->meta[META_END0 + space].load(std::memory_order_acquire);
+        const std::uint64_t from_end = f->meta[META_FROM_END].load(std::memory_order_acquire);
+        if (!in_space(space, end) || (draining && !in_space(from, from_end))) return ArenaError::BadFile;
+
+        bool full = false;
+        std::uint64_t reached = space_begin(space);
+        index_.write([&](IndexT& idx) {
+            if (draining) replay(idx, space_begin(from), from_end, full);
+            if (!full) reached = replay(idx, space_begin(space), end, full);
+        });
+        if (full) return ArenaError::IndexFull;
+
+        gc_.space = space;
+        arena_.reset(space_begin(space), space_end(space));
+        std::uint64_t ignored;
+        if (reached > space_begin(space)) arena_.alloc(reached - space_begin(space), ignored);
+        persist_end();
+        if (draining) {
+            gc_.active = true;
+            gc_.scan = space_begin(from);
+            gc_.scan_end = from_end;
+        }
+        return ArenaError::None;
+    }
+
+    /// \brief Publishes the entries of [at, end) in order. Must run inside index_.write().
+    /// \details Stops early at a header that does not decode (a torn tail), or when the index is
+    /// full (`full`). Dead entries are accounted for compaction as they are found.
+    /// \return Offset the walk reached.
+    std::uint64_t replay(IndexT& idx, std::uint64_t at, std::uint64_t end, bool& full) {
+        constexpr std::uint16_t known = EntryHeader::KEY_MASK | EntryHeader::FILLER | EntryHeader::DELETED;
+        while (end - at >= sizeof(EntryHeader)) {
+            auto* e = (const EntryHeader*)arena_.ptr_at(at);
+            const std::uint32_t size = footprint(e);
+            if ((e->klen & ~known) != 0 || size > end - at) break;
+
+            std::string_view key((const char*)(e + 1), e->klen & EntryHeader::KEY_MASK);
+            if (e->klen & (EntryHeader::FILLER | EntryHeader::DELETED)) {
+                if (e->klen & EntryHeader::DELETED) erase(idx, e->hash, key);
+                note_dead(at);
+            } else if (!publish(idx, e->hash, key, e->vlen, at)) {
+                full = true;
+                break;
+            }
+            at += size;
+        }
+        return at;
+    }
+
+    /// \brief Splits the Arena into half-spaces under ArenaMode::Compacting.
+    void use_mode(ArenaMode mode) {
+        if (mode == ArenaMode::Compacting) {
+            gc_.enabled = true;
+            gc_.half = (arena_.size() / 2) & ~std::uint64_t(7);
+            arena_.reset(space_begin(0), space_end(0));
+        }
+    }
+
     // Private Constructor prevents partial initialization.
-    Hyperion(Arena&& a, Index&& idx) 
-        : arena_(std::move(a)), index_(std::move(idx)) {}
+    BasicHyperion(Arena&& a, IndexT&& idx, ArenaMode mode) 
+        : arena_(std::move(a)), index_(std::move(idx)) {
+        use_mode(mode);
+    }
+
+    /// \brief Shared-memory construction: the writer (`fresh`) lays the lock counters and index
+    /// out in front of the Arena and publishes them; a reader adopts them as found.
+    BasicHyperion(Arena&& a, std::uint32_t slots, ArenaMode mode, bool fresh)
+        : arena_(std::move(a)),
+          index_(shared_index(arena_, slots, fresh), reinterpret_cast<std::uint8_t*>(arena_.shared()) + SHARED_LOCK, fresh) {
+        use_mode(mode);
+        if (fresh) {
+            ArenaSharedHeader* h = arena_.shared();
+            h->meta[SHM_FORMAT].store(format_word(), std::memory_order_relaxed);
+            h->meta[SHM_INDEX].store(shared_kind(), std::memory_order_relaxed);
+            h->meta[SHM_SLOTS].store(slots, std::memory_order_relaxed);
+            h->meta[SHM_TABLE].store(SHARED_TABLE, std::memory_order_relaxed);
+            arena_.publish();
+        }
+    }
+
+    /// \brief File-backed construction (see open()); `ae` reports whether attach() succeeded.
+    BasicHyperion(Arena&& a, IndexT&& idx, ArenaMode mode, ArenaError& ae)
+        : BasicHyperion(std::move(a), std::move(idx), mode) {
+        ae = attach();
+    }
 
     Arena arena_;
-    SeqLock<Index> index_;
-};
\ No newline at end of file
+    StripedSeqLock<IndexT> index_;
+    Compactor gc_;
+    WriteAheadLog* wal_ = nullptr; // Receives every applied write once recover() attached it.
+    std::unique_ptr<Snapshot> snap_; // Running snapshot; declared last so it stops before the Arena goes.
+    SnapshotError snap_result_ = SnapshotError::None;
+};
+
+/// \brief Default engine: linear probing index.
+using Hyperion = BasicHyperion<>;
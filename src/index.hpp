@@ -1,25 +1,51 @@
 #pragma once
 
+#include "hash.hpp"
+#include "memory.hpp"
 #include <cstdint>
 #include <memory>
 #include <cstring>
 #include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+/// \brief Non-binding prefetch of the cache line holding p (read intent, keep in all levels).
+inline void prefetch_line(const void* p) {
+    #if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p, 0, 3);
+    #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+    #else
+        (void)p;
+    #endif
+}
 
 /// \brief Fixed-size Index Slot.
 /// \details
 /// 16-byte structure aligned to 16 bytes. This enables potential SIMD optimizations
 /// (loading 4 slots into a 64-byte cache line or AVX-512 register).
+/// `offset` is an entry reference (Arena byte offset / 8). It is a full 64-bit word, so the
+/// Arena size is bounded only by address space, and readers load it in one access.
 struct alignas(16) Slot {
+    using offset_type = std::uint64_t;
+
     std::uint8_t  hash_tag;   // High 8 bits of hash for cheap comparisons
     std::uint8_t  key_len;    // Fast rejection filter
     std::uint16_t val_len;    // Data size metadata
-    std::uint32_t offset;     // Offset into Arena (0 = Invalid)
-    std::uint64_t _padding;   // Padding to force 16-byte alignment
+    std::uint32_t _padding;   // Keeps offset naturally aligned
+    std::uint64_t offset;     // Entry reference into Arena (0 = Invalid)
 
-    static constexpr std::uint32_t OFF_EMPTY = 0xFFFFFFFF;
-    static constexpr std::uint32_t OFF_TOMB = 0xFFFFFFFE;
+    static constexpr std::uint64_t OFF_EMPTY = UINT64_MAX;
+    static constexpr std::uint64_t OFF_TOMB = UINT64_MAX - 1;
 
-    static Slot empty() { return {0, 0, 0, OFF_EMPTY, 0}; }
+    static Slot empty() { return {0, 0, 0, 0, OFF_EMPTY}; }
+    static Slot make(std::uint8_t tag, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        return {tag, klen, vlen, 0, ref};
+    }
     
     bool is_empty() const { return offset == OFF_EMPTY; }
     bool is_tombstone() const { return offset == OFF_TOMB; }
@@ -28,89 +54,326 @@ struct alignas(16) Slot {
     void make_tombstone() { offset = OFF_TOMB; hash_tag = 0; }
 };
 
-/// \brief Open-Addressing Hash Index with Linear Probing.
-class Index {
+/// \brief Dense 8-byte Index Slot.
+/// \details
+/// Same fields as Slot without the padding word: 8 slots per 64-byte cache line instead of 4,
+/// halving the index footprint. Preferred once the index no longer fits in L2/L3.
+/// The 32-bit entry reference (Arena byte offset / 8) caps the Arena at 32 GiB.
+struct alignas(8) CompactSlot {
+    using offset_type = std::uint32_t;
+
+    std::uint8_t  hash_tag;   // High 8 bits of hash for cheap comparisons
+    std::uint8_t  key_len;    // Fast rejection filter
+    std::uint16_t val_len;    // Data size metadata
+    std::uint32_t offset;     // Entry reference into Arena (0 = Invalid)
+
+    static constexpr std::uint32_t OFF_EMPTY = 0xFFFFFFFF;
+    static constexpr std::uint32_t OFF_TOMB = 0xFFFFFFFE;
+
+    static CompactSlot empty() { return {0, 0, 0, OFF_EMPTY}; }
+    static CompactSlot make(std::uint8_t tag, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        return {tag, klen, vlen, static_cast<std::uint32_t>(ref)};
+    }
+
+    bool is_empty() const { return offset == OFF_EMPTY; }
+    bool is_tombstone() const { return offset == OFF_TOMB; }
+    bool is_valid() const { return offset < OFF_TOMB; }
+
+    void make_tombstone() { offset = OFF_TOMB; hash_tag = 0; }
+};
+
+static_assert(sizeof(Slot) == 16, "Slot must stay 16 bytes");
+static_assert(sizeof(CompactSlot) == 8, "CompactSlot must pack into 8 bytes");
+
+/// \brief Open-Addressing Hash Index with Linear Probing and incremental online growth.
+///
+/// \details
+/// When occupancy crosses the configured load factor, a table of double capacity is
+/// allocated and the old one is drained a few buckets per write (two-table scheme), so no
+/// single put pays an O(n) rehash. While draining, lookups probe the new table first and
+/// fall back to the old one; entries are moved by writing the new slot before tombstoning
+/// the old, and SeqLock readers that race a move simply retry.
+///
+/// Slot positions returned by find() address both tables: [0, cap) is the current table,
+/// [cap, cap + old_cap) the table being drained.
+///
+/// \tparam SlotT Slot layout: Slot (16-byte) or CompactSlot (8-byte).
+template <typename SlotT = Slot>
+class BasicIndex {
 public:
-    Index() = default;
+    using slot_type = SlotT;
+
+    /// Position returned by find() when no insertion candidate exists (table full).
+    static constexpr std::uint32_t NPOS = UINT32_MAX;
+    static constexpr float DEFAULT_MAX_LOAD = 0.75f;
+    /// Old-table buckets drained per write while a resize is in flight.
+    static constexpr std::uint32_t MIGRATE_STEP = 32;
+
+    BasicIndex() = default;
     
     // Move-only resource management
-    Index(Index&&) = default;
-    Index& operator=(Index&&) = default;
-    Index(const Index&) = delete;
-    Index& operator=(const Index&) = delete;
+    BasicIndex(BasicIndex&&) = default;
+    BasicIndex& operator=(BasicIndex&&) = default;
+    BasicIndex(const BasicIndex&) = delete;
+    BasicIndex& operator=(const BasicIndex&) = delete;
 
-    void init(std::uint32_t slots) {
+    /// \brief Page placement for slot tables allocated from now on (call before init()).
+    void set_memory(const MemoryOptions& mem) { mem_ = mem; }
+
+    /// \param max_load Occupancy (live + tombstones) that triggers growth. 0 = fixed capacity.
+    void init(std::uint32_t slots, float max_load = DEFAULT_MAX_LOAD) {
         // Enforce Power-of-Two capacity for bitwise masking (faster than modulo).
-        capacity_ = next_pow2(std::max(slots, 8u));
-        mask_ = capacity_ - 1;
-        slots_ = std::make_unique<Slot[]>(capacity_);
-        for(std::uint32_t i=0; i<capacity_; ++i) slots_[i] = Slot::empty();
+        tables_.clear();
+        cur_ = nullptr;
+        max_load_ = max_load;
+        cur_ = make_table(next_pow2(std::max(slots, 8u)));
+        old_ = nullptr;
+        size_ = 0;
     }
 
-    /// \brief FNV-1a Hash Implementation (32-bit).
-    static std::uint32_t hash(const std::uint8_t* data, std::size_t len) {
-        std::uint32_t h = 2166136261u;
-        for(std::size_t i=0; i<len; ++i) {
-            h ^= data[i];
-            h *= 16777619u;
+    /// Identifies the init_shared() layout to processes attaching to it.
+    static constexpr std::uint32_t SHARED_KIND = 1;
+
+    /// \brief Bytes init_shared() places for `slots` (rounded up as by init()).
+    static std::size_t shared_bytes(std::uint32_t slots) {
+        return std::size_t(next_pow2(std::max(slots, 8u))) * sizeof(SlotT);
+    }
+
+    /// \brief init() over shared_bytes(slots) of caller memory (64-byte aligned), e.g. a shared-memory region.
+    /// \details The capacity is fixed: a table other processes map cannot be reallocated. `fresh`
+    /// empties it; otherwise it is adopted as found, by a process attaching to a table another writes.
+    void init_shared(std::uint32_t slots, void* mem, bool fresh) {
+        tables_.clear();
+        max_load_ = 0.0f;
+        const std::uint32_t capacity = next_pow2(std::max(slots, 8u));
+        tables_.push_back(std::make_unique<Table>());
+        cur_ = tables_.back().get();
+        cur_->capacity = capacity;
+        cur_->mask = capacity - 1;
+        cur_->used = 0;
+        cur_->slots = PageArray<SlotT>::borrow(static_cast<SlotT*>(mem));
+        if (fresh) {
+            for(std::uint32_t i=0; i<capacity; ++i) cur_->slots[i] = SlotT::empty();
         }
-        return h;
+        old_ = nullptr;
+        size_ = 0;
+    }
+
+    /// \brief FNV-1a Hash Implementation (32-bit). See hash.hpp for faster policies.
+    static std::uint32_t hash(const std::uint8_t* data, std::size_t len) {
+        return Fnv1a::hash(data, len);
     }
 
     /// \brief Linear Probe Lookup.
     /// \param eq Functor for deep key comparison.
-    /// \return Pair {Index, Found}. If !Found, Index is the insertion candidate.
+    /// \return Pair {Index, Found}. If !Found, Index is the insertion candidate (or NPOS if full).
     template <typename KeyEq>
     std::pair<std::uint32_t, bool> find(std::uint32_t h, std::size_t klen, KeyEq&& eq) const {
+        // Snapshot table pointers once: each Table is immutable in shape and outlives readers.
+        const Table* cur = cur_;
+        const Table* old = old_;
         std::uint8_t tag = static_cast<std::uint8_t>(h >> 24);
-        std::uint32_t idx = h & mask_;
-        std::uint32_t first_tomb = UINT32_MAX;
+        std::uint32_t idx = h & cur->mask;
+        std::uint32_t first_tomb = NPOS;
 
         // Bounded probe loop. In production, max probe length should be monitored.
-        for(std::uint32_t i=0; i<capacity_; ++i) {
-            const Slot& s = slots_[idx];
+        for(std::uint32_t i=0; i<cur->capacity; ++i) {
+            const SlotT& s = cur->slots[idx];
             
             if (s.is_empty()) {
                 // Return first recycled tombstone if available, else current empty slot.
-                return { (first_tomb != UINT32_MAX) ? first_tomb : idx, false };
+                if (first_tomb == NPOS) first_tomb = idx;
+                break;
             }
             
             if (s.is_tombstone()) {
                 // Record first tombstone for recycling (Backshift/Tombstone optimization).
-                if (first_tomb == UINT32_MAX) first_tomb = idx;
+                if (first_tomb == NPOS) first_tomb = idx;
             } 
             else if (s.hash_tag == tag && s.key_len == klen) {
                 // Tag match -> Invoke deep comparison.
                 if (eq(s)) return {idx, true};
             }
             
-            idx = (idx + 1) & mask_;
+            idx = (idx + 1) & cur->mask;
         }
-        // Table Full fallback.
-        return { (first_tomb != UINT32_MAX) ? first_tomb : idx, false };
+
+        if (old != nullptr) {
+            // Resize in flight: the key may not have been migrated yet.
+            idx = h & old->mask;
+            for(std::uint32_t i=0; i<old->capacity; ++i) {
+                const SlotT& s = old->slots[idx];
+                if (s.is_empty()) break;
+                if (s.hash_tag == tag && s.key_len == klen && s.is_valid() && eq(s)) {
+                    return {cur->capacity + idx, true};
+                }
+                idx = (idx + 1) & old->mask;
+            }
+        }
+        // New keys always land in the current table. NPOS signals Table Full.
+        return {first_tomb, false};
     }
 
-    void update(std::uint32_t idx, std::uint8_t tag, std::uint8_t klen, std::uint16_t vlen, std::uint32_t off) {
-        Slot s;
-        s.hash_tag = tag;
-        s.key_len = klen;
-        s.val_len = vlen;
-        s.offset = off;
-        s._padding = 0;
-        slots_[idx] = s;
+    void update(std::uint32_t idx, std::uint8_t tag, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        at(idx) = SlotT::make(tag, klen, vlen, ref);
     }
-    
-    Slot& at(std::uint32_t idx) { return slots_[idx]; }
-    const Slot& at(std::uint32_t idx) const { return slots_[idx]; }
-    std::uint32_t cap() const { return capacity_; }
-    std::uint32_t mask() const { return mask_; }
+
+    /// \brief Inserts a new entry at the candidate returned by an unsuccessful find.
+    /// \return false if the table is full (idx == NPOS).
+    bool insert(std::uint32_t idx, std::uint32_t h, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        if (idx == NPOS) return false;
+        if (cur_->slots[idx].is_empty()) ++cur_->used;
+        ++size_;
+        update(idx, static_cast<std::uint8_t>(h >> 24), klen, vlen, ref);
+        return true;
+    }
+
+    /// \brief Removes the entry at idx, leaving a tombstone to keep probe chains intact.
+    void erase(std::uint32_t idx) {
+        at(idx).make_tombstone();
+        --size_;
+    }
+
+    /// \brief find() confined to the slots [h & mask(), hi), for parallel builds over disjoint ranges.
+    /// \details Only an Empty slot is offered as the insertion candidate, so insert_in() never
+    /// consumes a tombstone and bulk_done() can account the additions.
+    /// \return {idx, found} as find(), or {NPOS, false} if the answer lies outside the range
+    ///         (or a resize is in flight); the caller then falls back to find().
+    template <typename KeyEq>
+    std::pair<std::uint32_t, bool> find_in(std::uint32_t hi, std::uint32_t h, std::size_t klen, KeyEq&& eq) const {
+        if (old_ != nullptr) return {NPOS, false};
+        const std::uint8_t tag = static_cast<std::uint8_t>(h >> 24);
+        for(std::uint32_t idx = h & cur_->mask; idx < hi; ++idx) {
+            const SlotT& s = cur_->slots[idx];
+            if (s.is_empty()) return {idx, false};
+            if (s.hash_tag == tag && s.key_len == klen && s.is_valid() && eq(s)) return {idx, true};
+        }
+        return {NPOS, false};
+    }
+
+    /// \brief Stores a new entry at a candidate from find_in(). Touches only that slot.
+    void insert_in(std::uint32_t idx, std::uint32_t h, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        cur_->slots[idx] = SlotT::make(static_cast<std::uint8_t>(h >> 24), klen, vlen, ref);
+    }
+
+    /// \brief Accounts `added` keys stored by insert_in() once the parallel build has joined.
+    void bulk_done(std::uint32_t added) {
+        cur_->used += added;
+        size_ += added;
+    }
+
+    /// \brief Advances the online resize by one bounded step. Called by the writer before each put.
+    /// \param hash_of Functor returning the full 32-bit hash of a live Slot (needed to re-home it).
+    template <typename HashOf>
+    void migrate(HashOf&& hash_of) {
+        if (old_ == nullptr) {
+            if (!grow_due()) return;
+            // Double when genuinely full of live keys; otherwise rehash at the same size to purge tombstones.
+            bool live_heavy = size_ >= static_cast<std::uint32_t>(cur_->capacity * max_load_ / 2);
+            std::uint32_t next_cap = live_heavy ? cur_->capacity * 2 : cur_->capacity;
+            old_ = cur_;
+            cursor_ = 0;
+            cur_ = make_table(next_cap);
+        }
+
+        std::uint32_t end = std::min(cursor_ + MIGRATE_STEP, old_->capacity);
+        for(; cursor_ < end; ++cursor_) {
+            SlotT& s = old_->slots[cursor_];
+            if (!s.is_valid()) continue;
+            place(*cur_, hash_of(s), s);
+            s.make_tombstone();
+        }
+
+        if (cursor_ == old_->capacity) {
+            // Drained. The Table stays allocated in tables_ for readers still speculating on it.
+            old_ = nullptr;
+        }
+    }
+
+    /// \brief True if the next insert/update/erase touches only its target slot (no resize step
+    /// pending), so the write can be scoped to the key's StripedSeqLock stripe.
+    bool local_writes() const { return old_ == nullptr && !grow_due(); }
+
+    /// \brief Prefetches the home bucket of h (batched lookups issue this ahead of find()).
+    void prefetch(std::uint32_t h) const {
+        prefetch_line(&cur_->slots[h & cur_->mask]);
+    }
+
+    SlotT& at(std::uint32_t idx) {
+        return idx < cur_->capacity ? cur_->slots[idx] : old_->slots[idx - cur_->capacity];
+    }
+    const SlotT& at(std::uint32_t idx) const {
+        return idx < cur_->capacity ? cur_->slots[idx] : old_->slots[idx - cur_->capacity];
+    }
+    std::uint32_t cap() const { return cur_->capacity; }
+    std::uint32_t mask() const { return cur_->mask; }
+    std::uint32_t size() const { return size_; }
+    bool resizing() const { return old_ != nullptr; }
+
+    /// \brief Page size backing the current slot table.
+    PageMode page_mode() const { return cur_->slots.mode(); }
+
+    /// \brief True if the current slot table is pinned in RAM.
+    bool locked() const { return cur_->slots.locked(); }
+
+    /// \brief NUMA node the current slot table is bound to, -1 if unbound.
+    std::int32_t numa_node() const { return cur_->slots.numa_node(); }
 
 private:
+    struct Table {
+        std::uint32_t capacity;
+        std::uint32_t mask;
+        std::uint32_t used;      // Live + tombstone slots (drives the load factor).
+        PageArray<SlotT> slots;
+    };
+
     static std::uint32_t next_pow2(std::uint32_t v) {
         v--; v |= v >> 1; v |= v >> 2; v |= v >> 4; v |= v >> 8; v |= v >> 16; return v + 1;
     }
+
+    bool grow_due() const {
+        return max_load_ > 0.0f && cur_->used >= static_cast<std::uint32_t>(cur_->capacity * max_load_);
+    }
+
+    /// \brief Returns an empty table, recycling a retired one of the same capacity if possible.
+    /// \details Recycled memory is never unmapped, so a stale reader only ever sees well-formed
+    /// (if meaningless) slots within bounds, and its SeqLock validation discards the result.
+    Table* make_table(std::uint32_t capacity) {
+        Table* t = nullptr;
+        for (auto& r : tables_) {
+            if (r.get() != cur_ && r.get() != old_ && r->capacity == capacity) { t = r.get(); break; }
+        }
+        if (t == nullptr) {
+            tables_.push_back(std::make_unique<Table>());
+            t = tables_.back().get();
+            t->capacity = capacity;
+            t->mask = capacity - 1;
+            t->slots = PageArray<SlotT>(capacity, mem_);
+        }
+        t->used = 0;
+        for(std::uint32_t i=0; i<capacity; ++i) t->slots[i] = SlotT::empty();
+        return t;
+    }
+
+    /// \brief Re-homes a migrated slot. Keys are unique across tables, so no comparison is needed.
+    static void place(Table& t, std::uint32_t h, const SlotT& s) {
+        std::uint32_t idx = h & t.mask;
+        while (t.slots[idx].is_valid()) idx = (idx + 1) & t.mask;
+        if (t.slots[idx].is_empty()) ++t.used;
+        t.slots[idx] = s;
+    }
     
-    std::unique_ptr<Slot[]> slots_;
-    std::uint32_t capacity_ = 0;
-    std::uint32_t mask_ = 0;
-};
\ No newline at end of file
+    // Owns every table ever allocated. Retired tables are never freed while the index lives,
+    // because optimistic readers may still dereference them; same-size rehashes recycle them,
+    // so the total stays within a small multiple of the current table.
+    std::vector<std::unique_ptr<Table>> tables_;
+    Table* cur_ = nullptr;
+    Table* old_ = nullptr;
+    std::uint32_t cursor_ = 0;
+    std::uint32_t size_ = 0;
+    float max_load_ = DEFAULT_MAX_LOAD;
+    MemoryOptions mem_;
+};
+
+/// \brief Default index: linear probing over 16-byte Slots.
+using Index = BasicIndex<>;
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Platform Abstraction Layer (PAL) for file I/O
+#if defined(_WIN32)
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #if defined(__linux__) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #define HYPERION_IO_URING 1
+    #endif
+#endif
+
+/// \brief Minimal positional file I/O over the platform handle (no implicit file position).
+class File {
+public:
+    File() = default;
+    ~File() { close(); }
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    /// \brief Opens `path` read/write, creating it if missing.
+    /// \param truncate Empty an existing file (e.g. a snapshot being rewritten).
+    bool open(const char* path, bool truncate = false) {
+        close();
+        #if defined(_WIN32)
+            h_ = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                             truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            return h_ != INVALID_HANDLE_VALUE;
+        #else
+            fd_ = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+            return fd_ >= 0;
+        #endif
+    }
+
+    /// \brief Opens an existing `path` for reading only (e.g. a snapshot being restored).
+    bool open_read(const char* path) {
+        close();
+        #if defined(_WIN32)
+            h_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            return h_ != INVALID_HANDLE_VALUE;
+        #else
+            fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+            return fd_ >= 0;
+        #endif
+    }
+
+    void close() {
+        #if defined(_WIN32)
+            if (h_ != INVALID_HANDLE_VALUE) CloseHandle(h_);
+            h_ = INVALID_HANDLE_VALUE;
+        #else
+            if (fd_ >= 0) ::close(fd_);
+            fd_ = -1;
+        #endif
+    }
+
+    std::uint64_t size() const {
+        #if defined(_WIN32)
+            LARGE_INTEGER s{};
+            return GetFileSizeEx(h_, &s) ? static_cast<std::uint64_t>(s.QuadPart) : 0;
+        #else
+            struct stat st{};
+            return ::fstat(fd_, &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+        #endif
+    }
+
+    /// \brief Writes all of [p, p + n) at `off`.
+    bool write_at(std::uint64_t off, const void* data, std::size_t n) {
+        const char* p = static_cast<const char*>(data);
+        #if defined(_WIN32)
+            while (n > 0) {
+                OVERLAPPED ov{};
+                ov.Offset = static_cast<DWORD>(off);
+                ov.OffsetHigh = static_cast<DWORD>(off >> 32);
+                DWORD done = 0, part = static_cast<DWORD>(std::min<std::size_t>(n, 1u << 30));
+                if (!WriteFile(h_, p, part, &done, &ov)) return false;
+                p += done; n -= done; off += done;
+            }
+        #else
+            while (n > 0) {
+                ssize_t done = ::pwrite(fd_, p, n, static_cast<off_t>(off));
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) return false;
+                p += done; n -= static_cast<std::size_t>(done); off += static_cast<std::uint64_t>(done);
+            }
+        #endif
+        return true;
+    }
+
+    /// \brief Reads exactly n bytes at `off`.
+    bool read_at(std::uint64_t off, void* data, std::size_t n) const {
+        char* p = static_cast<char*>(data);
+        #if defined(_WIN32)
+            while (n > 0) {
+                OVERLAPPED ov{};
+                ov.Offset = static_cast<DWORD>(off);
+                ov.OffsetHigh = static_cast<DWORD>(off >> 32);
+                DWORD done = 0, part = static_cast<DWORD>(std::min<std::size_t>(n, 1u << 30));
+                if (!ReadFile(h_, p, part, &done, &ov) || done == 0) return false;
+                p += done; n -= done; off += done;
+            }
+        #else
+            while (n > 0) {
+                ssize_t done = ::pread(fd_, p, n, static_cast<off_t>(off));
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) return false;
+                p += done; n -= static_cast<std::size_t>(done); off += static_cast<std::uint64_t>(done);
+            }
+        #endif
+        return true;
+    }
+
+    bool truncate(std::uint64_t len) {
+        #if defined(_WIN32)
+            LARGE_INTEGER at{};
+            at.QuadPart = static_cast<LONGLONG>(len);
+            return SetFilePointerEx(h_, at, nullptr, FILE_BEGIN) && SetEndOfFile(h_);
+        #else
+            return ::ftruncate(fd_, static_cast<off_t>(len)) == 0;
+        #endif
+    }
+
+    /// \brief Flushes written data to stable storage (fdatasync / FlushFileBuffers).
+    bool sync() {
+        #if defined(_WIN32)
+            return FlushFileBuffers(h_) != 0;
+        #elif defined(__APPLE__)
+            return ::fsync(fd_) == 0;
+        #else
+            return ::fdatasync(fd_) == 0;
+        #endif
+    }
+
+    #if !defined(_WIN32)
+        int fd() const { return fd_; }
+    #endif
+
+private:
+    #if defined(_WIN32)
+        HANDLE h_ = INVALID_HANDLE_VALUE;
+    #else
+        int fd_ = -1;
+    #endif
+};
+
+/// \brief Atomically replaces `to` with `from` (e.g. a finished snapshot over the previous one).
+inline bool replace_file(const char* from, const char* to) {
+    #if defined(_WIN32)
+        return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    #else
+        return ::rename(from, to) == 0;
+    #endif
+}
+
+/// \brief I/O engine behind AsyncFile.
+enum class IoBackend : std::uint8_t {
+    Auto,    ///< io_uring when the kernel offers it, else Threads.
+    Uring,   ///< io_uring through raw syscalls (no liburing). Linux 5.6+.
+    Threads, ///< pwrite/fdatasync on a small worker pool. Portable.
+};
+
+/// \brief One asynchronous operation. `tag` comes back with its completion.
+struct IoRequest {
+    enum class Op : std::uint8_t { Write, Sync };
+    Op op;
+    const void* data;    // Write: must stay valid until the completion is reaped.
+    std::size_t len;
+    std::uint64_t off;
+    std::uint64_t tag;
+};
+
+/// \brief Asynchronous positional writes and syncs on a File.
+///
+/// \details
+/// submit() queues requests and returns without waiting for the disk: with io_uring it is one
+/// io_uring_enter that only submits, on the thread pool it is a queue push. Completions are
+/// collected with reap() (non-blocking) or wait() and reported as on_done(tag, result), where
+/// result is the byte count of a write, 0 for a sync, or a negative errno.
+///
+/// A Sync is a barrier (IOSQE_IO_DRAIN on io_uring): it starts only once every earlier request
+/// has completed, and later requests wait for it, so a completed Sync covers all writes
+/// submitted before it. Writes between barriers may complete in any order.
+///
+/// Not thread-safe: one thread (or a caller-held lock) drives submit/reap/wait.
+class AsyncFile {
+public:
+    AsyncFile() = default;
+    ~AsyncFile() { stop(); }
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    /// \brief Starts the backend over `file` (which must outlive this object).
+    /// \param depth   Maximum requests in flight.
+    /// \param threads Worker count of the Threads backend.
+    /// \return false if an explicitly requested backend is unavailable.
+    bool start(File& file, IoBackend want, std::uint32_t depth = 64, std::uint32_t threads = 2) {
+        stop();
+        file_ = &file;
+        depth_ = std::max(depth, 2u);
+        #if defined(HYPERION_IO_URING)
+            if (want != IoBackend::Threads && ring_.init(depth_, file.fd())) {
+                backend_ = IoBackend::Uring;
+                return true;
+            }
+        #endif
+        if (want == IoBackend::Uring) return false;
+        backend_ = IoBackend::Threads;
+        pool_stop_ = false;
+        for (std::uint32_t i = 0; i < std::max(threads, 1u); ++i) workers_.emplace_back([this] { work(); });
+        return true;
+    }
+
+    /// \brief Waits for every request in flight, then releases the backend.
+    void stop() {
+        while (in_flight_ != 0) wait([](std::uint64_t, std::int64_t) {});
+        #if defined(HYPERION_IO_URING)
+            ring_.close();
+        #endif
+        if (!workers_.empty()) {
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                pool_stop_ = true;
+            }
+            work_cv_.notify_all();
+            for (auto& t : workers_) t.join();
+            workers_.clear();
+        }
+    }
+
+    IoBackend backend() const { return backend_; }
+    std::uint32_t in_flight() const { return in_flight_; }
+    std::uint32_t capacity() const { return depth_ - in_flight_; }
+
+    /// \brief Queues n requests (n <= capacity()). Never waits for I/O.
+    /// \return false if not all were queued. A prefix may still have been, and it completes
+    /// (and is reported) as usual.
+    bool submit(const IoRequest* reqs, std::uint32_t n) {
+        if (n > capacity()) return false;
+        #if defined(HYPERION_IO_URING)
+            if (backend_ == IoBackend::Uring) {
+                // Whatever the kernel accepted will complete, even if the rest was refused.
+                const std::uint32_t sent = ring_.submit(reqs, n);
+                in_flight_ += sent;
+                return sent == n;
+            }
+        #endif
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            for (std::uint32_t i = 0; i < n; ++i) queue_.push_back(reqs[i]);
+        }
+        in_flight_ += n;
+        work_cv_.notify_all();
+        return true;
+    }
+
+    /// \brief Reports every completion already available. Never blocks.
+    template <typename Fn>
+    std::uint32_t reap(Fn&& on_done) { return collect(on_done, false); }
+
+    /// \brief Blocks until at least one request completes (if any is in flight), then reports.
+    template <typename Fn>
+    std::uint32_t wait(Fn&& on_done) { return in_flight_ == 0 ? 0 : collect(on_done, true); }
+
+private:
+    template <typename Fn>
+    std::uint32_t collect(Fn& on_done, bool block) {
+        std::uint32_t n = 0;
+        #if defined(HYPERION_IO_URING)
+            if (backend_ == IoBackend::Uring) {
+                n = ring_.reap(on_done, block);
+                in_flight_ -= n;
+                return n;
+            }
+        #endif
+        std::vector<Done> done;
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            if (block) done_cv_.wait(lk, [&] { return !done_.empty(); });
+            done.swap(done_);
+        }
+        for (const Done& d : done) on_done(d.tag, d.result);
+        n = static_cast<std::uint32_t>(done.size());
+        in_flight_ -= n;
+        return n;
+    }
+
+    struct Done {
+        std::uint64_t tag;
+        std::int64_t result;
+    };
+
+    /// \brief Pool worker. A Sync is only taken from the front with nothing else running, and
+    /// nothing is taken while it runs, matching IOSQE_IO_DRAIN.
+    void work() {
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            work_cv_.wait(lk, [&] {
+                return pool_stop_ || (!queue_.empty() && !syncing_ && (queue_.front().op == IoRequest::Op::Write || running_ == 0));
+            });
+            if (pool_stop_) return;
+            IoRequest r = queue_.front();
+            queue_.pop_front();
+            ++running_;
+            syncing_ = r.op == IoRequest::Op::Sync;
+            lk.unlock();
+
+            std::int64_t result;
+            if (r.op == IoRequest::Op::Write) result = file_->write_at(r.off, r.data, r.len) ? static_cast<std::int64_t>(r.len) : -EIO;
+            else result = file_->sync() ? 0 : -EIO;
+
+            lk.lock();
+            --running_;
+            if (r.op == IoRequest::Op::Sync) syncing_ = false;
+            done_.push_back({r.tag, result});
+            done_cv_.notify_all();
+            work_cv_.notify_all(); // A barrier may be waiting for running_ to drain, or requests for a barrier.
+        }
+    }
+
+    #if defined(HYPERION_IO_URING)
+        /// \brief io_uring instance driven through raw syscalls and its shared-memory rings.
+        class Ring {
+        public:
+            bool init(std::uint32_t entries, int fd) {
+                io_uring_params p{};
+                int rfd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+                if (rfd < 0) return false;
+                ring_fd_ = rfd;
+                // IORING_OP_WRITE and non-dropping completions need 5.6; older rings use the pool.
+                if ((p.features & IORING_FEAT_RW_CUR_POS) == 0 || (p.features & IORING_FEAT_NODROP) == 0) { close(); return false; }
+                file_fd_ = fd;
+                entries_ = p.sq_entries;
+
+                sq_bytes_ = p.sq_off.array + p.sq_entries * sizeof(std::uint32_t);
+                cq_bytes_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+                single_ = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_) sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+
+                sq_ = ::mmap(nullptr, sq_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rfd, IORING_OFF_SQ_RING);
+                if (sq_ == MAP_FAILED) { sq_ = nullptr; close(); return false; }
+                if (single_) {
+                    cq_ = sq_;
+                } else {
+                    cq_ = ::mmap(nullptr, cq_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rfd, IORING_OFF_CQ_RING);
+                    if (cq_ == MAP_FAILED) { cq_ = nullptr; close(); return false; }
+                }
+                sqe_bytes_ = p.sq_entries * sizeof(io_uring_sqe);
+                void* sqes = ::mmap(nullptr, sqe_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rfd, IORING_OFF_SQES);
+                if (sqes == MAP_FAILED) { close(); return false; }
+                sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+                auto* sq = static_cast<std::uint8_t*>(sq_);
+                auto* cq = static_cast<std::uint8_t*>(cq_);
+                sq_head_ = reinterpret_cast<std::uint32_t*>(sq + p.sq_off.head);
+                sq_tail_ = reinterpret_cast<std::uint32_t*>(sq + p.sq_off.tail);
+                sq_mask_ = *reinterpret_cast<std::uint32_t*>(sq + p.sq_off.ring_mask);
+                sq_array_ = reinterpret_cast<std::uint32_t*>(sq + p.sq_off.array);
+                cq_head_ = reinterpret_cast<std::uint32_t*>(cq + p.cq_off.head);
+                cq_tail_ = reinterpret_cast<std::uint32_t*>(cq + p.cq_off.tail);
+                cq_mask_ = *reinterpret_cast<std::uint32_t*>(cq + p.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+                return true;
+            }
+
+            void close() {
+                if (sqes_) ::munmap(sqes_, sqe_bytes_);
+                if (cq_ && !single_) ::munmap(cq_, cq_bytes_);
+                if (sq_) ::munmap(sq_, sq_bytes_);
+                if (ring_fd_ >= 0) ::close(ring_fd_);
+                sqes_ = nullptr; cq_ = nullptr; sq_ = nullptr; ring_fd_ = -1;
+            }
+
+            /// Times submit() backs off on EAGAIN/EBUSY before reporting failure.
+            static constexpr std::uint32_t SUBMIT_RETRIES = 64;
+
+            /// \brief Fills n SQEs and submits them with one io_uring_enter (no waiting).
+            /// \return How many the kernel accepted, in order; those will complete. Any that were
+            /// refused are taken back out of the ring.
+            std::uint32_t submit(const IoRequest* reqs, std::uint32_t n) {
+                std::uint32_t tail = *sq_tail_;
+                const std::uint32_t head = std::atomic_ref<std::uint32_t>(*sq_head_).load(std::memory_order_acquire);
+                if (entries_ - (tail - head) < n) return 0;
+
+                for (std::uint32_t i = 0; i < n; ++i, ++tail) {
+                    const std::uint32_t idx = tail & sq_mask_;
+                    io_uring_sqe* sqe = &sqes_[idx];
+                    std::memset(sqe, 0, sizeof(*sqe));
+                    sqe->fd = file_fd_;
+                    sqe->user_data = reqs[i].tag;
+                    if (reqs[i].op == IoRequest::Op::Write) {
+                        sqe->opcode = IORING_OP_WRITE;
+                        sqe->addr = reinterpret_cast<std::uint64_t>(reqs[i].data);
+                        sqe->len = static_cast<std::uint32_t>(reqs[i].len);
+                        sqe->off = reqs[i].off;
+                    } else {
+                        sqe->opcode = IORING_OP_FSYNC;
+                        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+                        sqe->flags = IOSQE_IO_DRAIN;
+                    }
+                    sq_array_[idx] = idx;
+                }
+                std::atomic_ref<std::uint32_t>(*sq_tail_).store(tail, std::memory_order_release);
+
+                // EAGAIN/EBUSY mean the kernel is short of resources or the CQ is full; back off a
+                // bounded number of times rather than spin. Consuming nothing is a failure too.
+                std::uint32_t retries = 0;
+                std::uint32_t left = n;
+                while (left > 0) {
+                    long r = ::syscall(__NR_io_uring_enter, ring_fd_, left, 0u, 0u, nullptr, 0ul);
+                    if (r < 0) {
+                        if (errno == EINTR) continue;
+                        if ((errno == EAGAIN || errno == EBUSY) && ++retries <= SUBMIT_RETRIES) {
+                            std::this_thread::yield();
+                            continue;
+                        }
+                        break;
+                    }
+                    if (r == 0) break;
+                    left -= static_cast<std::uint32_t>(r);
+                }
+                // Without SQPOLL the kernel consumes SQEs only inside io_uring_enter, so the
+                // unconsumed tail can be withdrawn before a later call submits it unaccounted.
+                if (left > 0) std::atomic_ref<std::uint32_t>(*sq_tail_).store(tail - left, std::memory_order_release);
+                return n - left;
+            }
+
+            template <typename Fn>
+            std::uint32_t reap(Fn& on_done, bool block) {
+                std::atomic_ref<std::uint32_t> tail_ref(*cq_tail_);
+                std::uint32_t head = *cq_head_;
+                if (block && head == tail_ref.load(std::memory_order_acquire)) {
+                    while (::syscall(__NR_io_uring_enter, ring_fd_, 0u, 1u, IORING_ENTER_GETEVENTS, nullptr, 0ul) < 0 && errno == EINTR) {}
+                }
+                const std::uint32_t tail = tail_ref.load(std::memory_order_acquire);
+                std::uint32_t n = 0;
+                for (; head != tail; ++head, ++n) {
+                    const io_uring_cqe& c = cqes_[head & cq_mask_];
+                    on_done(c.user_data, static_cast<std::int64_t>(c.res));
+                }
+                std::atomic_ref<std::uint32_t>(*cq_head_).store(head, std::memory_order_release);
+                return n;
+            }
+
+        private:
+            int ring_fd_ = -1;
+            int file_fd_ = -1;
+            std::uint32_t entries_ = 0;
+            bool single_ = false;
+            void* sq_ = nullptr;
+            void* cq_ = nullptr;
+            std::size_t sq_bytes_ = 0, cq_bytes_ = 0, sqe_bytes_ = 0;
+            io_uring_sqe* sqes_ = nullptr;
+            std::uint32_t* sq_head_ = nullptr;
+            std::uint32_t* sq_tail_ = nullptr;
+            std::uint32_t* sq_array_ = nullptr;
+            std::uint32_t sq_mask_ = 0;
+            std::uint32_t* cq_head_ = nullptr;
+            std::uint32_t* cq_tail_ = nullptr;
+            std::uint32_t cq_mask_ = 0;
+            io_uring_cqe* cqes_ = nullptr;
+        };
+
+        Ring ring_;
+    #endif
+
+    File* file_ = nullptr;
+    IoBackend backend_ = IoBackend::Threads;
+    std::uint32_t depth_ = 0;
+    std::uint32_t in_flight_ = 0;
+
+    // Threads backend.
+    std::mutex m_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<IoRequest> queue_;
+    std::vector<Done> done_;
+    std::uint32_t running_ = 0;
+    bool syncing_ = false;          // A Sync is running: later requests wait for it.
+    bool pool_stop_ = false;
+    std::vector<std::thread> workers_;
+};
@@ -1,6 +1,21 @@
 #include "hyperion.hpp"
+#include "sharded.hpp"
+#include "write_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
 #include <cassert>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
 
 int main() {
     ArenaError ae;
@@ -32,6 +47,795 @@ int main() {
     assert(db.get("user:1001", val) == Status::OK);
     assert(val == "balance:0");
 
+    // 5. SIMD Group Probing (SwissIndex)
+    // Fill to ~90% load so probes span multiple control groups, then churn deletes.
+    auto sdb = BasicHyperion<SwissIndex>::create(64 * 1024 * 1024, 1024, ae);
+    assert(ae == ArenaError::None);
+    for (int i = 0; i < 920; ++i) {
+        assert(sdb.put("sym:" + std::to_string(i), "px:" + std::to_string(i)) == Status::OK);
+    }
+    for (int i = 0; i < 920; i += 2) {
+        assert(sdb.del("sym:" + std::to_string(i)) == Status::OK);
+    }
+    for (int i = 0; i < 920; ++i) {
+        [[maybe_unused]] Status st = sdb.get("sym:" + std::to_string(i), val);
+        if (i % 2 == 0) {
+            assert(st == Status::NotFound);
+        } else {
+            assert(st == Status::OK && val == "px:" + std::to_string(i));
+        }
+    }
+    assert(sdb.put("sym:0", "px:reborn") == Status::OK);
+    assert(sdb.get("sym:0", val) == Status::OK && val == "px:reborn");
+
+    // 6. Compact 8-byte Slot Layout
+    auto cdb = BasicHyperion<BasicIndex<CompactSlot>>::create(64 * 1024 * 1024, 1024, ae);
+    assert(ae == ArenaError::None);
+    assert(cdb.put("user:2002", "balance:7000") == Status::OK);
+    assert(cdb.put("user:2002", "balance:6500") == Status::OK);
+    assert(cdb.get("user:2002", val) == Status::OK && val == "balance:6500");
+    assert(cdb.del("user:2002") == Status::OK);
+    assert(cdb.get("user:2002", val) == Status::NotFound);
+
+    // 7. Robin Hood Index: Backward-Shift Deletion under Churn
+    // Repeated delete/insert cycles at ~90% load must never degrade or lose keys.
+    auto rdb = BasicHyperion<RobinHoodIndex>::create(64 * 1024 * 1024, 1024, ae);
+    assert(ae == ArenaError::None);
+    for (int i = 0; i < 920; ++i) {
+        assert(rdb.put("ord:" + std::to_string(i), "qty:" + std::to_string(i)) == Status::OK);
+    }
+    for (int round = 1; round <= 20; ++round) {
+        for (int i = round % 3; i < 920; i += 3) {
+            assert(rdb.del("ord:" + std::to_string(i)) == Status::OK);
+            assert(rdb.put("ord:" + std::to_string(i), "qty:" + std::to_string(i + round)) == Status::OK);
+        }
+    }
+    for (int i = 0; i < 920; ++i) {
+        assert(rdb.get("ord:" + std::to_string(i), val) == Status::OK);
+        assert(val.rfind("qty:", 0) == 0);
+    }
+    assert(rdb.del("ord:5") == Status::OK);
+    assert(rdb.get("ord:5", val) == Status::NotFound);
+    assert(rdb.del("ord:5") == Status::NotFound);
+
+    // 8. Online Index Growth
+    // Start with 8 slots; the index must grow incrementally without losing or duplicating keys.
+    Index gidx;
+    gidx.init(8, 0.5f);
+    auto gdb = Hyperion::create(64 * 1024 * 1024, std::move(gidx), ae);
+    assert(ae == ArenaError::None);
+    for (int i = 0; i < 5000; ++i) {
+        assert(gdb.put("px:" + std::to_string(i), std::to_string(i)) == Status::OK);
+        if (i % 7 == 0) assert(gdb.put("px:" + std::to_string(i / 2), "upd") == Status::OK);
+    }
+    for (int i = 0; i < 5000; i += 5) {
+        assert(gdb.del("px:" + std::to_string(i)) == Status::OK);
+    }
+    for (int i = 0; i < 5000; ++i) {
+        [[maybe_unused]] Status st = gdb.get("px:" + std::to_string(i), val);
+        assert((i % 5 == 0) ? st == Status::NotFound : st == Status::OK);
+    }
+
+    // 9. Hash Policies
+    // Every policy must round-trip through the engine, including keys longer than one mixing round.
+    [[maybe_unused]] const char* probe = "123456789";
+    assert(Crc32cHash::hash((const std::uint8_t*)probe, 9) != Crc32cHash::hash((const std::uint8_t*)probe, 8));
+    assert(MixHash::hash((const std::uint8_t*)probe, 9) != MixHash::hash((const std::uint8_t*)probe, 8));
+    auto mdb = BasicHyperion<Index, MixHash>::create(64 * 1024 * 1024, 1024, ae);
+    auto xdb = BasicHyperion<SwissIndex, Crc32cHash>::create(64 * 1024 * 1024, 1024, ae);
+    for (int i = 0; i < 500; ++i) {
+        std::string k = "instrument:" + std::string(static_cast<std::size_t>(i % 40), 'x') + std::to_string(i);
+        assert(mdb.put(k, k) == Status::OK && xdb.put(k, k) == Status::OK);
+    }
+    for (int i = 0; i < 500; ++i) {
+        std::string k = "instrument:" + std::string(static_cast<std::size_t>(i % 40), 'x') + std::to_string(i);
+        assert(mdb.get(k, val) == Status::OK && val == k);
+        assert(xdb.get(k, val) == Status::OK && val == k);
+    }
+
+    // 10. Zero-Copy Views
+    ValueView view;
+    assert(db.put("blob:md", std::string(4096, 'q')) == Status::OK);
+    assert(db.get_view("blob:md", view) == Status::OK);
+    assert(view.value.size() == 4096 && view.value.front() == 'q' && db.validate(view));
+    assert(db.put("blob:md", "v2") == Status::OK);
+    // Any subsequent write invalidates the view; the old bytes remain readable (append-only).
+    assert(!db.validate(view) && view.value.back() == 'q');
+    assert(db.get_view("blob:md", view) == Status::OK && view.value == "v2");
+    assert(db.get_view("blob:none", view) == Status::NotFound);
+
+    // 11. Caller-Buffer and Visitor Reads
+    [[maybe_unused]] char buf[16];
+    [[maybe_unused]] std::size_t len = 0;
+    [[maybe_unused]] std::string_view key_sv = "blob:md";
+    assert(db.get(key_sv, std::span<char>(buf), len) == Status::OK && std::string_view(buf, len) == "v2");
+    assert(db.put("blob:md", std::string(64, 'z')) == Status::OK);
+    assert(db.get(key_sv, std::span<char>(buf), len) == Status::BufferTooSmall && len == 64);
+    [[maybe_unused]] std::size_t seen = 0;
+    assert(db.get_with(key_sv, [&](std::string_view v) { seen = v.size(); }) == Status::OK && seen == 64);
+    assert(db.get_with("blob:none", [&](std::string_view) { seen = 0; }) == Status::NotFound && seen == 64);
+
+    // 12. Binary and Integral Key Overloads
+    [[maybe_unused]] const std::byte raw_key[] = {std::byte{0x01}, std::byte{0x00}, std::byte{0xFF}};
+    [[maybe_unused]] const std::byte raw_val[] = {std::byte{0xAB}, std::byte{0xCD}};
+    [[maybe_unused]] std::byte raw_out[4];
+    assert(db.put(std::span<const std::byte>(raw_key), std::span<const std::byte>(raw_val)) == Status::OK);
+    assert(db.get(std::span<const std::byte>(raw_key), std::span<std::byte>(raw_out), len) == Status::OK);
+    assert(len == 2 && raw_out[0] == std::byte{0xAB} && raw_out[1] == std::byte{0xCD});
+    assert(db.del(std::span<const std::byte>(raw_key)) == Status::OK);
+
+    // Heterogeneous integers: stored as uint64_t, found via int; negatives stay distinct.
+    assert(db.put(std::uint64_t{42}, "answer") == Status::OK);
+    assert(db.put(-42, "negative") == Status::OK);
+    assert(db.get(42, val) == Status::OK && val == "answer");
+    assert(db.get(std::int16_t{-42}, val) == Status::OK && val == "negative");
+    assert(db.del(42u) == Status::OK && db.get(std::uint64_t{42}, val) == Status::NotFound);
+
+    // 13. Batched Multi-Get (spans more than one prefetch batch)
+    std::vector<std::string> mkeys;
+    for (int i = 0; i < 100; ++i) {
+        mkeys.push_back("mg:" + std::to_string(i));
+        if (i % 4 != 0) assert(db.put(mkeys.back(), "v" + std::to_string(i)) == Status::OK);
+    }
+    std::vector<std::string_view> mviews(mkeys.begin(), mkeys.end());
+    std::vector<ValueView> mout(mkeys.size());
+    std::vector<Status> mstatus(mkeys.size());
+    assert(db.multi_get(mviews, mout, mstatus) == 75);
+    for (int i = 0; i < 100; ++i) {
+        if (i % 4 == 0) {
+            assert(mstatus[i] == Status::NotFound);
+        } else {
+            assert(mstatus[i] == Status::OK && mout[i].value == "v" + std::to_string(i));
+        }
+    }
+
+    // 14. Batched Writes (single allocation, single SeqLock publish)
+    std::vector<std::string> bkeys, bvals;
+    for (int i = 0; i < 200; ++i) {
+        bkeys.push_back("wb:" + std::to_string(i % 150));
+        bvals.push_back("gen" + std::to_string(i));
+    }
+    std::vector<KeyValue> batch;
+    for (int i = 0; i < 200; ++i) batch.push_back({bkeys[i], bvals[i]});
+    assert(db.write_batch(batch) == Status::OK);
+    // Keys 0..49 appear twice; the later entry wins.
+    assert(db.get("wb:10", val) == Status::OK && val == "gen160");
+    assert(db.get("wb:100", val) == Status::OK && val == "gen100");
+    std::string long_key(MAX_KEY + 1, 'k');
+    batch.push_back({long_key, "x"});
+    assert(db.write_batch(batch) == Status::KeyTooLong);
+
+    // 15. Striped SeqLock: unrelated writes do not invalidate readers
+    auto tdb = BasicHyperion<SwissIndex>::create(64 * 1024 * 1024, 1024, ae);
+    assert(tdb.put("stripe:a", "1") == Status::OK);
+    assert(tdb.get_view("stripe:a", view) == Status::OK);
+    std::string other;
+    for (int i = 0;; ++i) {
+        other = "stripe:b" + std::to_string(i);
+        std::uint32_t oh = Fnv1a::hash((const std::uint8_t*)other.data(), other.size());
+        if (StripedSeqLock<SwissIndex>::stripe_of(oh) != view.version.index) break;
+    }
+    assert(tdb.put(other, "2") == Status::OK && tdb.validate(view));
+    assert(tdb.put("stripe:a", "3") == Status::OK && !tdb.validate(view));
+
+    // 16. Sharded Engine: concurrent writers on every shard
+    auto shdb = ShardedHyperion::create(4, 16 * 1024 * 1024, 1024, ae);
+    assert(ae == ArenaError::None && shdb.shard_count() == 4);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&shdb, t] {
+            for (int i = 0; i < 2000; ++i) {
+                std::string k = "sh:" + std::to_string(t) + ":" + std::to_string(i);
+                assert(shdb.put(k, k) == Status::OK);
+            }
+        });
+    }
+    for (auto& w : writers) w.join();
+    for (int t = 0; t < 4; ++t) {
+        for (int i = 0; i < 2000; ++i) {
+            std::string k = "sh:" + std::to_string(t) + ":" + std::to_string(i);
+            assert(shdb.get(k, val) == Status::OK && val == k);
+        }
+    }
+    assert(shdb.shard(shdb.shard_of("sh:0:0")).get("sh:0:0", val) == Status::OK);
+    assert(shdb.del("sh:0:0") == Status::OK && shdb.get("sh:0:0", val) == Status::NotFound);
+    {
+        // The key-level API matches Hyperion's, so generic readers and writers take either.
+        auto drop_in = [&]([[maybe_unused]] auto& db) {
+            [[maybe_unused]] const std::byte bkey[] = {std::byte{0xB1}, std::byte{0x0B}};
+            [[maybe_unused]] const std::byte bval[] = {std::byte{0x42}};
+            [[maybe_unused]] std::byte bout[4];
+            [[maybe_unused]] std::size_t len = 0;
+            assert(db.put(std::span<const std::byte>(bkey), std::span<const std::byte>(bval)) == Status::OK);
+            assert(db.get(std::span<const std::byte>(bkey), std::span<std::byte>(bout), len) == Status::OK && len == 1 && bout[0] == bval[0]);
+            assert(db.put(std::uint32_t{77}, "int") == Status::OK && db.get(std::uint64_t{77}, val) == Status::OK && val == "int");
+            assert(db.get_with(77, [](std::string_view v) { return v.size(); }) == Status::OK);
+
+            std::vector<std::string> ks;
+            for (int i = 0; i < 100; ++i) ks.push_back("di:" + std::to_string(i));
+            for (int i = 0; i < 100; i += 2) assert(db.put(ks[i], ks[i]) == Status::OK);
+            std::vector<std::string_view> kv(ks.begin(), ks.end());
+            std::vector<ValueView> views(kv.size());
+            std::vector<Status> sts(kv.size());
+            assert(db.multi_get(kv, views, sts) == 50);
+            for (int i = 0; i < 100; ++i) {
+                assert(sts[i] == (i % 2 == 0 ? Status::OK : Status::NotFound));
+                assert(i % 2 != 0 || (views[i].value == ks[i] && db.validate(views[i])));
+            }
+            [[maybe_unused]] ValueView view;
+            assert(db.get_view(std::uint64_t{77}, view) == Status::OK && view.value == "int" && db.validate(view));
+            assert(db.put(77, "INT") == Status::OK && !db.validate(view));
+            assert(db.del(std::span<const std::byte>(bkey)) == Status::OK && db.del(77) == Status::OK);
+        };
+        auto plain = Hyperion::create(16 * 1024 * 1024, 1024, ae);
+        drop_in(plain);
+        drop_in(shdb);
+    }
+
+    // 17. Write Queue: many producers, one owned writer thread
+    auto qdb = Hyperion::create(16 * 1024 * 1024, 1024, ae);
+    {
+        WriteQueue q(qdb, 64);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t) {
+            producers.emplace_back([&q, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    std::string k = "wq:" + std::to_string(t) + ":" + std::to_string(i);
+                    assert(q.post_put(k, k) == Status::OK);
+                }
+            });
+        }
+        for (auto& p : producers) p.join();
+        auto f = q.put("wq:last", "1");
+        assert(q.del("wq:0:0").get() == Status::OK);
+        assert(f.get() == Status::OK);
+        assert(q.del("wq:missing").get() == Status::NotFound);
+        assert(q.put(long_key, "x").get() == Status::KeyTooLong);
+        q.post_put("wq:tail", "t");
+        q.flush();
+        assert(qdb.get("wq:tail", val) == Status::OK && val == "t");
+    }
+    for (int t = 0; t < 4; ++t) {
+        for (int i = (t == 0); i < 1000; ++i) {
+            std::string k = "wq:" + std::to_string(t) + ":" + std::to_string(i);
+            assert(qdb.get(k, val) == Status::OK && val == k);
+        }
+    }
+    assert(qdb.get("wq:0:0", val) == Status::NotFound);
+
+    // 18. Arena Compaction: overwrite churn far beyond the Arena size
+    auto gcdb = Hyperion::create(1024 * 1024, 256, ae, ArenaMode::Compacting);
+    std::atomic<bool> churning{true};
+    std::thread reader([&gcdb, &churning] {
+        std::string v;
+        while (churning.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 200; i += 7) {
+                std::string k = "q:" + std::to_string(i);
+                if (gcdb.get(k, v) == Status::OK) assert(v.compare(0, k.size() + 1, k + "=") == 0);
+            }
+        }
+    });
+    std::string payload(48, 'p');
+    for (int round = 0; round < 500; ++round) {
+        for (int i = 0; i < 200; ++i) {
+            std::string k = "q:" + std::to_string(i);
+            assert(gcdb.put(k, k + "=" + std::to_string(round) + payload) == Status::OK);
+        }
+        if (round % 50 == 0) assert(gcdb.del("q:0") == Status::OK);
+    }
+    churning.store(false);
+    reader.join();
+    for (int i = 0; i < 200; ++i) {
+        std::string k = "q:" + std::to_string(i);
+        assert(gcdb.get(k, val) == Status::OK && val == k + "=499" + payload);
+    }
+    gcdb.compact();
+    assert(gcdb.arena_used() < 200 * 128);
+    auto fulldb = Hyperion::create(1024 * 1024, 256, ae);
+    Status last = Status::OK;
+    for (int i = 0; i < 20000 && last == Status::OK; ++i) last = fulldb.put("q:" + std::to_string(i), payload);
+    assert(last == Status::ArenaFull);
+
+    // 19. In-place Overwrite: values that fit their entry consume no Arena space
+    auto ipdb = Hyperion::create(1024 * 1024, 256, ae, ArenaMode::Compacting);
+    assert(ipdb.put("px:AAPL", "00187.25") == Status::OK);
+    [[maybe_unused]] std::size_t used = ipdb.arena_used();
+    assert(ipdb.get_view("px:AAPL", view) == Status::OK);
+    for (int i = 0; i < 10000; ++i) assert(ipdb.put("px:AAPL", std::to_string(10000000 + i)) == Status::OK);
+    assert(ipdb.arena_used() == used && !ipdb.validate(view));
+    assert(ipdb.get("px:AAPL", val) == Status::OK && val == "10009999");
+    // Shrinking leaves a filler entry; growing past the footprint appends a new entry.
+    assert(ipdb.put("px:AAPL", std::string(40, 'w')) == Status::OK && ipdb.arena_used() > used);
+    used = ipdb.arena_used();
+    assert(ipdb.put("px:AAPL", "1") == Status::OK && ipdb.arena_used() == used);
+    assert(ipdb.put("px:MSFT", "2") == Status::OK);
+    assert(ipdb.get("px:AAPL", val) == Status::OK && val == "1");
+    ipdb.compact();
+    assert(ipdb.get("px:AAPL", val) == Status::OK && val == "1");
+    assert(ipdb.get("px:MSFT", val) == Status::OK && val == "2");
+
+    // 20. 64-bit Arena: entries addressed beyond 4 GiB (reserved up front, backed on touch)
+    auto bigdb = Hyperion::create(16ULL << 30, 1024, ae, ArenaMode::Compacting);
+    assert(ae == ArenaError::None);
+    assert(bigdb.put("big:a", "1") == Status::OK);
+    assert(bigdb.put("big:a", std::string(100, 'a')) == Status::OK);
+    assert(bigdb.put("big:b", "2") == Status::OK);
+    bigdb.compact(); // Live entries move to the upper half-space, 8 GiB in.
+    assert(bigdb.get("big:a", val) == Status::OK && val == std::string(100, 'a'));
+    assert(bigdb.get("big:b", val) == Status::OK && val == "2");
+    assert(bigdb.put("big:c", "3") == Status::OK && bigdb.get("big:c", val) == Status::OK && val == "3");
+    // CompactSlot's 32-bit reference caps its Arena at 32 GiB.
+    auto capped = BasicHyperion<BasicIndex<CompactSlot>>::create(64ULL << 30, 1024, ae);
+    assert(ae == ArenaError::TooLarge);
+
+    // 21. Huge Pages: requests degrade gracefully and the achieved mode is reported
+    [[maybe_unused]] auto below = [](PageMode got, PageMode want) { return static_cast<int>(got) <= static_cast<int>(want); };
+    auto pgdb = Hyperion::create(64 * 1024 * 1024, 1 << 18, ae);
+    assert(pgdb.arena_page_mode() == PageMode::Small && pgdb.index_page_mode() == PageMode::Small);
+    for (PageMode want : {PageMode::Transparent, PageMode::Huge2M, PageMode::Huge1G}) {
+        auto hp = Hyperion::create(64 * 1024 * 1024, 1 << 18, ae, ArenaMode::Compacting, MemoryOptions{want});
+        assert(ae == ArenaError::None);
+        assert(below(hp.arena_page_mode(), want) && below(hp.index_page_mode(), want));
+        auto sw = BasicHyperion<SwissIndex>::create(64 * 1024 * 1024, 1 << 18, ae, ArenaMode::Monotonic, MemoryOptions{want});
+        auto rh = BasicHyperion<RobinHoodIndex>::create(64 * 1024 * 1024, 1 << 18, ae, ArenaMode::Monotonic, MemoryOptions{want});
+        for (int i = 0; i < 5000; ++i) {
+            std::string k = "hp:" + std::to_string(i);
+            assert(hp.put(k, k) == Status::OK && sw.put(k, k) == Status::OK && rh.put(k, k) == Status::OK);
+        }
+        for (int i = 0; i < 5000; i += 7) {
+            std::string k = "hp:" + std::to_string(i);
+            assert(hp.get(k, val) == Status::OK && val == k);
+            assert(sw.get(k, val) == Status::OK && val == k);
+            assert(rh.get(k, val) == Status::OK && val == k);
+        }
+    }
+    // Tables smaller than a huge page stay on base pages.
+    auto tiny = Hyperion::create(1024 * 1024, 64, ae, ArenaMode::Monotonic, MemoryOptions{PageMode::Huge1G});
+    assert(tiny.index_page_mode() == PageMode::Small && tiny.put("t", "1") == Status::OK);
+
+    // 22. Pre-faulting: a resident Arena takes no first-touch faults while it fills
+    const std::string kb(1000, 'f');
+    for (std::uint32_t threads : {0u, 4u}) {
+        MemoryOptions mem;
+        mem.prefault = true;
+        mem.prefault_threads = threads;
+        auto pfdb = Hyperion::create(48 * 1024 * 1024, 1 << 16, ae, ArenaMode::Monotonic, mem);
+        assert(ae == ArenaError::None);
+        #if !defined(_WIN32)
+            rusage before{}, after{};
+            getrusage(RUSAGE_SELF, &before);
+        #endif
+        for (int i = 0; i < 40000; ++i) assert(pfdb.put(std::to_string(i), kb) == Status::OK);
+        #if !defined(_WIN32)
+            getrusage(RUSAGE_SELF, &after);
+            assert(after.ru_minflt - before.ru_minflt < 1000); // ~10000 pages written
+        #endif
+        assert(pfdb.get("39999", val) == Status::OK && val == kb);
+    }
+    MemoryOptions pinned;
+    pinned.lock = true;
+    auto lkdb = BasicHyperion<SwissIndex>::create(4 * 1024 * 1024, 1 << 12, ae, ArenaMode::Compacting, pinned);
+    assert(ae == ArenaError::None);
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 500; ++i) assert(lkdb.put(std::to_string(i), kb.substr(0, 100 + round)) == Status::OK);
+    }
+    assert(lkdb.get("499", val) == Status::OK && val == kb.substr(0, 119));
+    (void)lkdb.memory_locked(); // May be refused under RLIMIT_MEMLOCK; the engine still works.
+
+    // 23. NUMA Placement: bind to a node via mbind; unknown nodes fall back to first touch
+    for (std::int32_t node : {0, 1000}) {
+        MemoryOptions numa;
+        numa.numa_node = node;
+        numa.prefault = true;
+        auto nudb = BasicHyperion<RobinHoodIndex>::create(8 * 1024 * 1024, 1 << 12, ae, ArenaMode::Monotonic, numa);
+        assert(ae == ArenaError::None);
+        assert(nudb.numa_node() == node || nudb.numa_node() == -1);
+        if (node == 1000) assert(nudb.numa_node() == -1);
+        for (int i = 0; i < 1000; ++i) assert(nudb.put(std::to_string(i), kb) == Status::OK);
+        assert(nudb.get("999", val) == Status::OK && val == kb);
+    }
+
+    // 24. File-backed Arena: entries, overwrites and deletes survive a reopen
+    const std::string path = (std::filesystem::temp_directory_path() / "hyperion_check.arena").string();
+    std::remove(path.c_str());
+    {
+        auto fdb = Hyperion::open(path.c_str(), 4 * 1024 * 1024, 1024, ae);
+        assert(ae == ArenaError::None && fdb.persistent());
+        for (int i = 0; i < 2000; ++i) assert(fdb.put("f:" + std::to_string(i), std::to_string(i)) == Status::OK);
+        assert(fdb.put("f:1", std::string(64, 'g')) == Status::OK); // Grows: appends a new entry.
+        assert(fdb.put("f:2", "x") == Status::OK);                  // Shrinks in place: filler.
+        assert(fdb.del("f:3") == Status::OK && fdb.del("f:3") == Status::NotFound);
+        assert(fdb.put("", "empty") == Status::OK);
+        assert(fdb.sync());
+    }
+    {
+        auto fdb = Hyperion::open(path.c_str(), 4 * 1024 * 1024, 1024, ae);
+        assert(ae == ArenaError::None);
+        assert(fdb.get("f:1", val) == Status::OK && val == std::string(64, 'g'));
+        assert(fdb.get("f:2", val) == Status::OK && val == "x");
+        assert(fdb.get("f:3", val) == Status::NotFound);
+        assert(fdb.get("f:1999", val) == Status::OK && val == "1999");
+        assert(fdb.get("", val) == Status::OK && val == "empty");
+        assert(fdb.put("f:3", "back") == Status::OK);
+    }
+    {
+        auto fdb = Hyperion::open(path.c_str(), 4 * 1024 * 1024, 1024, ae);
+        assert(fdb.get("f:3", val) == Status::OK && val == "back");
+    }
+    // A file only reopens with the size and mode that wrote it.
+    { auto bad = Hyperion::open(path.c_str(), 8 * 1024 * 1024, 1024, ae); assert(ae == ArenaError::BadFile); }
+    { auto bad = Hyperion::open(path.c_str(), 4 * 1024 * 1024, 1024, ae, ArenaMode::Compacting); assert(ae == ArenaError::BadFile); }
+    std::remove(path.c_str());
+    // Compacting: the live half-space (and an interrupted cycle) is replayed.
+    for (int stop : {0, 1}) {
+        {
+            auto fdb = Hyperion::open(path.c_str(), 1024 * 1024, 256, ae, ArenaMode::Compacting);
+            assert(ae == ArenaError::None);
+            // Writes stay outside assert: the compaction cycle below needs them under NDEBUG too.
+            for (int round = 0; round < 200; ++round) {
+                for (int i = 0; i < 100; ++i) {
+                    std::string k = "c:" + std::to_string(i);
+                    [[maybe_unused]] const Status s = fdb.put(k, k + "=" + std::to_string(round) + payload);
+                    assert(s == Status::OK);
+                }
+            }
+            [[maybe_unused]] const Status gone = fdb.del("c:0");
+            assert(gone == Status::OK);
+            // Grow then shrink one key until a cycle is caught mid-way, then "crash".
+            while (stop == 1 && !fdb.compact_step()) {
+                [[maybe_unused]] const Status grown = fdb.put("c:1", "c:1=199" + payload + payload);
+                [[maybe_unused]] const Status shrunk = fdb.put("c:1", "c:1=199" + payload);
+                assert(grown == Status::OK && shrunk == Status::OK);
+            }
+        }
+        auto fdb = Hyperion::open(path.c_str(), 1024 * 1024, 256, ae, ArenaMode::Compacting);
+        assert(ae == ArenaError::None);
+        assert(fdb.get("c:0", val) == Status::NotFound);
+        for (int i = 1; i < 100; ++i) {
+            std::string k = "c:" + std::to_string(i);
+            assert(fdb.get(k, val) == Status::OK && val == k + "=199" + payload);
+        }
+        fdb.compact();
+        assert(fdb.arena_used() < 100 * 128);
+        std::remove(path.c_str());
+    }
+
+    // 25. Write-Ahead Log: every sync policy and I/O backend replays puts and deletes; a torn tail is dropped
+    const std::string wal_path = (std::filesystem::temp_directory_path() / "hyperion_check.wal").string();
+    for (int run = 0; run < 6; ++run) {
+        const WalSync policy = static_cast<WalSync>(run % 3);
+        std::remove(wal_path.c_str());
+        WalOptions wo;
+        wo.sync = policy;
+        wo.io = run < 3 ? IoBackend::Auto : IoBackend::Threads; // io_uring where the kernel allows it.
+        wo.groups = 2;
+        wo.records = 100;
+        wo.buffer_bytes = 4096; // Many small groups.
+        [[maybe_unused]] WalError we;
+        [[maybe_unused]] std::uint64_t replayed = 0;
+        {
+            auto wal = WriteAheadLog::open(wal_path.c_str(), wo, we);
+            assert(we == WalError::None && wal);
+            assert(run < 3 || wal->backend() == IoBackend::Threads);
+            auto wdb = Hyperion::create(16 * 1024 * 1024, 1024, ae);
+            assert(wdb.recover(*wal, replayed) == WalError::None && replayed == 0);
+            for (int i = 0; i < 3000; ++i) assert(wdb.put("w:" + std::to_string(i), std::to_string(i)) == Status::OK);
+            assert(wdb.put("w:7", "seven") == Status::OK);
+            [[maybe_unused]] KeyValue kvs[] = {{"wb:a", "1"}, {"wb:b", "2"}};
+            assert(wdb.write_batch(kvs) == Status::OK);
+            assert(wdb.del("w:8") == Status::OK && wdb.del("w:missing") == Status::NotFound);
+            assert(wal->sync() && wal->durable() == wal->appended() && wal->appended() == 3004);
+        }
+        {
+            // Tear the last record, as a crash mid-write would.
+            std::filesystem::resize_file(wal_path, std::filesystem::file_size(wal_path) - 3);
+            auto wal = WriteAheadLog::open(wal_path.c_str(), wo, we);
+            auto wdb = Hyperion::create(16 * 1024 * 1024, 1024, ae);
+            assert(wdb.recover(*wal, replayed) == WalError::None && replayed == 3003);
+            assert(wdb.get("w:7", val) == Status::OK && val == "seven");
+            assert(wdb.get("w:8", val) == Status::OK); // Its delete was the torn record.
+            assert(wdb.get("wb:b", val) == Status::OK && val == "2");
+            assert(wdb.del("w:8") == Status::OK);
+        }
+        auto wal = WriteAheadLog::open(wal_path.c_str(), wo, we);
+        auto wdb = Hyperion::create(16 * 1024 * 1024, 1024, ae);
+        assert(wdb.recover(*wal, replayed) == WalError::None && replayed == 3004);
+        assert(wdb.get("w:8", val) == Status::NotFound && wdb.get("w:2999", val) == Status::OK && val == "2999");
+    }
+    for (IoBackend io : {IoBackend::Auto, IoBackend::Threads}) {
+        // WalSync::Interval: a writer that goes idle still has every record written and synced
+        // on the timer, including any it spilled while the committer held the group.
+        std::remove(wal_path.c_str());
+        WalOptions wo;
+        wo.sync = WalSync::Interval;
+        wo.interval_ms = 1;
+        wo.io = io;
+        [[maybe_unused]] WalError we;
+        auto wal = WriteAheadLog::open(wal_path.c_str(), wo, we);
+        for (int i = 0; i < 20000; ++i) wal->append(WalOp::Put, "idle:" + std::to_string(i), "v");
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (wal->durable() < 20000 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert(wal->durable() == 20000);
+        // A second handle, opened while the first is still live and never synced, reads them all.
+        auto reader = WriteAheadLog::open(wal_path.c_str(), wo, we);
+        [[maybe_unused]] std::uint64_t replayed = 0;
+        [[maybe_unused]] const WalError re = reader->replay([](WalOp, std::string_view, std::string_view) {}, replayed);
+        assert(re == WalError::None && replayed == 20000);
+    }
+    {
+        // A batch cut short by IndexFull logs only the entries it published.
+        std::remove(wal_path.c_str());
+        [[maybe_unused]] WalError we;
+        auto wal = WriteAheadLog::open(wal_path.c_str(), WalOptions{}, we);
+        auto fdb = BasicHyperion<SwissIndex>::create(1024 * 1024, 16, ae);
+        [[maybe_unused]] std::uint64_t replayed = 0;
+        assert(fdb.recover(*wal, replayed) == WalError::None);
+        std::vector<std::string> keys;
+        for (int i = 0; i < 40; ++i) keys.push_back("full:" + std::to_string(i));
+        std::vector<KeyValue> batch;
+        for (const auto& k : keys) batch.push_back({k, "v"});
+        assert(fdb.write_batch(batch) == Status::IndexFull);
+        std::uint64_t stored = 0;
+        for (const auto& k : keys) stored += fdb.get(k, val) == Status::OK;
+        assert(stored > 0 && stored < keys.size() && wal->appended() == stored);
+
+        // Replaying into an engine too small for the log reports it instead of dropping records.
+        wal.reset(); // Commits the log; fdb writes nothing more.
+        auto wal2 = WriteAheadLog::open(wal_path.c_str(), WalOptions{}, we);
+        auto tiny = Hyperion::create(256, 1024, ae);
+        assert(tiny.recover(*wal2, replayed) == WalError::ApplyFailed);
+    }
+    {
+        // Anything that does not start with the log magic is refused.
+        std::FILE* junk = std::fopen(wal_path.c_str(), "wb");
+        std::fputs("not a log", junk);
+        std::fclose(junk);
+        [[maybe_unused]] WalError we;
+        assert(WriteAheadLog::open(wal_path.c_str(), WalOptions{}, we) == nullptr && we == WalError::BadFile);
+    }
+    std::remove(wal_path.c_str());
+
+    // 26. Snapshots: the file holds the state at snapshot() while the writer keeps mutating
+    const std::string snap_path = (std::filesystem::temp_directory_path() / "hyperion_check.snap").string();
+    for (int run = 0; run < 4; ++run) {
+        const ArenaMode mode = run < 2 ? ArenaMode::Monotonic : ArenaMode::Compacting;
+        SnapshotOptions so;
+        so.io = (run & 1) ? IoBackend::Threads : IoBackend::Auto;
+        so.buffer_bytes = 1; // Clamped to the smallest block: many blocks in flight.
+        so.buffers = 2;
+        auto sdb = Hyperion::create(32 * 1024 * 1024, 1 << 16, ae, mode);
+        assert(ae == ArenaError::None);
+        std::unordered_map<std::string, std::string> want;
+        // Writes and snapshots stay outside assert so NDEBUG builds test the same state.
+        auto put = [&](const std::string& k, const std::string& v) {
+            [[maybe_unused]] const Status s = sdb.put(k, v);
+            assert(s == Status::OK);
+            want[k] = v;
+        };
+        for (int i = 0; i < 20000; ++i) put("s:" + std::to_string(i), std::to_string(i) + payload);
+        for (int i = 0; i < 1000; ++i) put("s:" + std::to_string(i), "short"); // Shrinks in place.
+        [[maybe_unused]] const Status gone = sdb.del("s:5");
+        assert(gone == Status::OK);
+        want.erase("s:5");
+        // Compacting: take the snapshot in the middle of a cycle.
+        for (int i = 0; mode == ArenaMode::Compacting && !sdb.compact_step(); ++i) {
+            put("s:7", std::to_string(i) + payload + payload);
+            put("s:7", std::to_string(i));
+        }
+
+        [[maybe_unused]] const SnapshotError started = sdb.snapshot(snap_path.c_str(), so);
+        assert(started == SnapshotError::None);
+        // Overwrite, delete and add keys the snapshot is still reading.
+        // `want` keeps the snapshot's state, so these go straight to sdb.
+        for (int i = 0; i < 20000; ++i) {
+            [[maybe_unused]] const Status s = sdb.put("s:" + std::to_string(i), "x");
+            assert(s == Status::OK);
+        }
+        for (int i = 0; i < 2000; ++i) {
+            [[maybe_unused]] const Status s = sdb.del("s:" + std::to_string(i * 3));
+            assert(s == Status::OK);
+        }
+        [[maybe_unused]] const Status added = sdb.put("s:new", "after");
+        assert(added == Status::OK);
+        [[maybe_unused]] const SnapshotError done = sdb.snapshot_wait();
+        assert(done == SnapshotError::None && !sdb.snapshot_running());
+        assert(sdb.get("s:1", val) == Status::OK && val == "x");
+
+        [[maybe_unused]] std::uint64_t restored = 0;
+        auto rdb = Hyperion::create(32 * 1024 * 1024, 1 << 16, ae);
+        assert(rdb.restore(snap_path.c_str(), restored) == SnapshotError::None && restored == want.size());
+        for ([[maybe_unused]] const auto& [k, v] : want) assert(rdb.get(k, val) == Status::OK && val == v);
+        assert(rdb.get("s:5", val) == Status::NotFound && rdb.get("s:new", val) == Status::NotFound);
+        if (run == 0) {
+            // Another hash policy recomputes the stored hashes.
+            auto cdb = BasicHyperion<Index, Crc32cHash>::create(32 * 1024 * 1024, 1 << 16, ae);
+            assert(cdb.restore(snap_path.c_str(), restored) == SnapshotError::None && restored == want.size());
+            assert(cdb.get("s:19999", val) == Status::OK && val == want["s:19999"]);
+        }
+        // The next snapshot sees the writes made during this one; compaction resumes afterwards.
+        [[maybe_unused]] const SnapshotError again = sdb.snapshot(snap_path.c_str(), so);
+        [[maybe_unused]] const SnapshotError again_done = sdb.snapshot_wait();
+        assert(again == SnapshotError::None && again_done == SnapshotError::None);
+        auto ndb = Hyperion::create(32 * 1024 * 1024, 1 << 16, ae);
+        assert(ndb.restore(snap_path.c_str(), restored) == SnapshotError::None && restored == 20000 - 2000 + 1);
+        assert(ndb.get("s:1", val) == Status::OK && val == "x" && ndb.get("s:new", val) == Status::OK);
+        sdb.compact();
+        if (mode == ArenaMode::Compacting) assert(sdb.arena_used() < 20000 * 64);
+    }
+    {
+        // Missing, foreign and truncated files are refused.
+        [[maybe_unused]] std::uint64_t restored = 0;
+        auto rdb = Hyperion::create(1024 * 1024, 1024, ae);
+        std::filesystem::resize_file(snap_path, std::filesystem::file_size(snap_path) - 1);
+        assert(rdb.restore(snap_path.c_str(), restored) == SnapshotError::BadFile);
+        std::FILE* junk = std::fopen(snap_path.c_str(), "wb");
+        std::fputs("not a snapshot", junk);
+        std::fclose(junk);
+        assert(rdb.restore(snap_path.c_str(), restored) == SnapshotError::BadFile);
+        std::remove(snap_path.c_str());
+        assert(rdb.restore(snap_path.c_str(), restored) == SnapshotError::OpenFailed);
+    }
+
+    // 27. Bulk Load: parallel builds match serial puts on every index, with duplicates and spills
+    {
+        std::vector<std::string> keys;
+        std::vector<KeyValue> dump;
+        for (int i = 0; i < 120000; ++i) keys.push_back("b:" + std::to_string(i % 100000));
+        for (int i = 0; i < 120000; ++i) dump.push_back({keys[i], keys[(i + 7) % 120000]}); // Last 20000 repeat keys.
+        auto check = [&]([[maybe_unused]] auto& bdb) {
+            for (int i = 0; i < 100000; i += 7) {
+                [[maybe_unused]] const int last = i < 20000 ? i + 100000 : i;
+                assert(bdb.get(keys[i], val) == Status::OK && val == keys[(last + 7) % 120000]);
+            }
+        };
+        {
+            auto bdb = Hyperion::create(64 * 1024 * 1024, 1 << 18, ae);
+            assert(bdb.bulk_load(dump, 4) == Status::OK);
+            check(bdb);
+            assert(bdb.put("b:new", "1") == Status::OK && bdb.get("b:new", val) == Status::OK);
+        }
+        {
+            // Undersized: most keys spill and the table grows while they are published.
+            auto bdb = Hyperion::create(64 * 1024 * 1024, 1024, ae);
+            assert(bdb.bulk_load(dump, 4) == Status::OK);
+            check(bdb);
+        }
+        {
+            auto bdb = BasicHyperion<SwissIndex>::create(64 * 1024 * 1024, 1 << 17, ae);
+            assert(bdb.bulk_load(dump, 3) == Status::OK);
+            check(bdb);
+        }
+        {
+            auto bdb = BasicHyperion<RobinHoodIndex>::create(64 * 1024 * 1024, 1 << 17, ae);
+            assert(bdb.put("b:5", "old") == Status::OK); // Existing keys are superseded.
+            assert(bdb.bulk_load(dump, 4) == Status::OK);
+            check(bdb);
+            assert(bdb.del("b:5") == Status::OK && bdb.get("b:5", val) == Status::NotFound);
+        }
+        {
+            auto bdb = BasicHyperion<BasicIndex<CompactSlot>>::create(64 * 1024 * 1024, 1 << 18, ae, ArenaMode::Compacting);
+            assert(bdb.bulk_load(dump, 4) == Status::OK);
+            check(bdb);
+            [[maybe_unused]] const std::size_t used = bdb.arena_used();
+            bdb.compact(); // The 20000 superseded entries were accounted as dead.
+            assert(bdb.arena_used() < used);
+            check(bdb);
+        }
+        {
+            // The log receives exactly what a build cut short by IndexFull published.
+            std::remove(wal_path.c_str());
+            [[maybe_unused]] WalError we;
+            [[maybe_unused]] std::uint64_t replayed = 0;
+            auto wal = WriteAheadLog::open(wal_path.c_str(), WalOptions{}, we);
+            auto bdb = BasicHyperion<SwissIndex>::create(64 * 1024 * 1024, 1 << 16, ae);
+            assert(bdb.recover(*wal, replayed) == WalError::None);
+            assert(bdb.bulk_load(dump, 4) == Status::IndexFull);
+            wal.reset(); // Commits the log; bdb logs nothing more.
+            auto wal2 = WriteAheadLog::open(wal_path.c_str(), WalOptions{}, we);
+            auto rdb = Hyperion::create(64 * 1024 * 1024, 1 << 18, ae);
+            assert(rdb.recover(*wal2, replayed) == WalError::None && replayed > 0 && replayed < dump.size());
+            std::string rval;
+            for (int i = 0; i < 100000; ++i) {
+                [[maybe_unused]] const Status st = bdb.get(keys[i], val);
+                assert(rdb.get(keys[i], rval) == st && (st != Status::OK || rval == val));
+            }
+            wal2.reset();
+            std::remove(wal_path.c_str());
+            std::vector<KeyValue> bad(dump.begin(), dump.end());
+            std::string long_key(MAX_KEY + 1, 'k');
+            bad[99999].key = long_key;
+            assert(bdb.bulk_load(bad, 4) == Status::KeyTooLong);
+        }
+    }
+
+    // 28. Shared Memory: one writer publishes, readers in other mappings and processes get with no IPC
+    const char* shm_name = "/hyperion_check";
+    {
+        auto run = [&](auto* engine, ArenaMode mode) {
+            using DB = std::remove_pointer_t<decltype(engine)>;
+            auto wdb = DB::create_shared(shm_name, 2 * 1024 * 1024, 4096, ae, mode);
+            assert(ae == ArenaError::None);
+            // Writes stay outside assert: readers (and the child below) wait on them under NDEBUG too.
+            for (int i = 0; i < 2000; ++i) {
+                [[maybe_unused]] const Status s = wdb.put("m:" + std::to_string(i), std::to_string(i));
+                assert(s == Status::OK);
+            }
+
+            // A second, read-only mapping at another address resolves the same offsets.
+            auto rdb = DB::attach_shared(shm_name, ae);
+            assert(ae == ArenaError::None && rdb != nullptr);
+            for (int i = 0; i < 2000; ++i) assert(rdb->get("m:" + std::to_string(i), val) == Status::OK && val == std::to_string(i));
+            ValueView view;
+            assert(rdb->get_view("m:7", view) == Status::OK && view.value == "7" && rdb->validate(view));
+            [[maybe_unused]] const Status changed = wdb.put("m:7", "seven");
+            [[maybe_unused]] const Status gone = wdb.del("m:8");
+            assert(changed == Status::OK && gone == Status::OK);
+            assert(!rdb->validate(view));
+            assert(rdb->get("m:7", val) == Status::OK && val == "seven" && rdb->get("m:8", val) == Status::NotFound);
+
+            // Readers retry around a writer churning (and, when Compacting, recycling) the Arena.
+            std::atomic<bool> stop{false};
+            std::thread reader([&] {
+                std::string got;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    for (int i = 100; i < 200; ++i) {
+                        // Either the value put above (until the churn reaches this key) or a churned one.
+                        const std::string k = "m:" + std::to_string(i);
+                        assert(rdb->get(k, got) == Status::OK && (got == std::to_string(i) || got.compare(0, k.size(), k) == 0));
+                    }
+                }
+            });
+            for (int round = 0; round < 300; ++round) {
+                for (int i = 100; i < 200; ++i) {
+                    const std::string k = "m:" + std::to_string(i);
+                    [[maybe_unused]] const Status s = wdb.put(k, k + "=" + std::to_string(round) + payload);
+                    assert(s == Status::OK);
+                }
+            }
+            stop = true;
+            reader.join();
+
+            #if !defined(_WIN32)
+                // A reader process sees writes made after it attached.
+                assert(wdb.del("m:done") == Status::NotFound);
+                const pid_t child = fork();
+                if (child == 0) {
+                    auto cdb = DB::attach_shared(shm_name, ae);
+                    std::string got;
+                    while (cdb->get("m:done", got) != Status::OK) std::this_thread::yield();
+                    const bool ok = cdb->get("m:1999", got) == Status::OK && got == "late" && cdb->get("m:0", got) == Status::NotFound;
+                    _exit(ok ? 0 : 1);
+                }
+                // Each write runs unconditionally: "m:done" must land even if an earlier one failed.
+                const Status late = wdb.put("m:1999", "late");
+                const Status gone0 = wdb.del("m:0");
+                const Status done = wdb.put("m:done", "1");
+                [[maybe_unused]] const bool posted = late == Status::OK && gone0 == Status::OK && done == Status::OK;
+                int status = 0;
+                [[maybe_unused]] const bool reaped = waitpid(child, &status, 0) == child;
+                assert(posted && reaped && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+            #endif
+            return rdb;
+        };
+        auto last = run(static_cast<Hyperion*>(nullptr), ArenaMode::Monotonic);
+        run(static_cast<BasicHyperion<SwissIndex>*>(nullptr), ArenaMode::Compacting);
+        run(static_cast<BasicHyperion<BasicRobinHoodIndex<CompactSlot>>*>(nullptr), ArenaMode::Monotonic);
+
+        // The writer is gone and its name with it; an attached reader keeps its last state.
+        assert(last->get("m:1", val) == Status::OK && val == "1");
+        assert(Hyperion::attach_shared(shm_name, ae) == nullptr && ae == ArenaError::FileFailed);
+        auto wdb = Hyperion::create_shared(shm_name, 1024 * 1024, 64, ae);
+        assert(BasicHyperion<SwissIndex>::attach_shared(shm_name, ae) == nullptr && ae == ArenaError::BadFile);
+        using MixDB [[maybe_unused]] = BasicHyperion<Index, MixHash>;
+        assert(MixDB::attach_shared(shm_name, ae) == nullptr && ae == ArenaError::BadFile);
+        // The index is fixed-capacity: it never reallocates under its readers.
+        Status st = Status::OK;
+        for (int i = 0; i < 100 && st == Status::OK; ++i) st = wdb.put("x:" + std::to_string(i), "x");
+        assert(st == Status::IndexFull);
+    }
+
     std::cout << "Hyperion Integrity Check: PASSED.\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,566 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Platform Abstraction Layer (PAL) for page-size aware mappings
+#if defined(_WIN32)
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #if !defined(MAP_HUGE_SHIFT)
+        #define MAP_HUGE_SHIFT 26
+    #endif
+#endif
+
+/// \brief Page size backing a memory region, both as requested and as achieved.
+/// \details Ordered from smallest to largest page: a request that cannot be satisfied falls
+/// back one step at a time until a mapping succeeds.
+enum class PageMode : std::uint8_t {
+    Small,       ///< Base pages (4 KiB).
+    Transparent, ///< Base pages advised MADV_HUGEPAGE; the kernel promotes 2 MiB runs when it can.
+    Huge2M,      ///< Explicit 2 MiB huge pages (MAP_HUGETLB; Windows large pages).
+    Huge1G,      ///< Explicit 1 GiB huge pages (MAP_HUGETLB | MAP_HUGE_1GB).
+};
+
+/// \brief Placement options for Arena and Index memory, passed to the create() factories.
+struct MemoryOptions {
+    PageMode pages = PageMode::Small; ///< Requested page size for the Arena and the index arrays.
+    /// Fault every page in at create() so no write on the hot path takes a first-touch fault.
+    bool prefault = false;
+    /// Threads write-touching the Arena when prefaulting. 0 lets the kernel populate the
+    /// mapping (MAP_POPULATE), which is single-threaded; large Arenas fill faster in parallel.
+    std::uint32_t prefault_threads = 0;
+    /// Pin the memory (mlock / VirtualLock) so it is never paged out. Implies prefault.
+    bool lock = false;
+    /// NUMA node to allocate from (-1 = first-touch default). Bind before any page is touched.
+    std::int32_t numa_node = -1;
+
+    bool resident() const { return prefault || lock; }
+};
+
+/// \brief Bytes per page of a mode (Transparent is reported at its promotion size).
+inline constexpr std::size_t page_bytes(PageMode m) {
+    switch (m) {
+        case PageMode::Huge1G: return std::size_t(1) << 30;
+        case PageMode::Huge2M:
+        case PageMode::Transparent: return std::size_t(2) << 20;
+        default: return 4096;
+    }
+}
+
+inline const char* page_mode_name(PageMode m) {
+    switch (m) {
+        case PageMode::Huge1G: return "1G";
+        case PageMode::Huge2M: return "2M";
+        case PageMode::Transparent: return "THP";
+        default: return "4K";
+    }
+}
+
+/// \brief An OS mapping and the page size actually backing it.
+struct MappedRegion {
+    void* ptr = nullptr;
+    std::size_t bytes = 0; // Mapped length: the request rounded up to the page size.
+    PageMode mode = PageMode::Small;
+    bool locked = false;   // Pinned in RAM.
+    std::int32_t node = -1; // NUMA node the pages are bound to, -1 if unbound.
+    bool shared = false;    // A view of a file (map_file()), released by unmap_file().
+};
+
+/// Highest NUMA node id accepted by MemoryOptions::numa_node.
+inline constexpr std::int32_t MAX_NUMA_NODE = 1023;
+
+/// \brief Maps `bytes` of zero-filled read/write memory, degrading the page mode until one succeeds.
+/// \details Huge modes never exceed the request: a region smaller than one huge page starts at
+/// the next smaller mode, so small tables do not pin a whole 1 GiB or 2 MiB page.
+///
+/// Explicit huge pages are reserved from the hugetlbfs pool at map time (no MAP_NORESERVE),
+/// so an exhausted pool fails here and falls back instead of raising SIGBUS on first touch.
+/// \param lazy Back base pages on demand: MAP_NORESERVE on Linux, reserve-only on Windows
+///             (the caller commits). Ignored for explicit huge pages.
+/// \param populate Pre-fault explicit huge and base pages with MAP_POPULATE (Linux only).
+///        Transparent mappings are never populated here: the kernel would fill them with base
+///        pages before MADV_HUGEPAGE applies.
+/// \param node Windows only: preferred NUMA node (VirtualAllocExNuma). Linux binds afterwards.
+/// \return ptr == nullptr if even base pages could not be mapped.
+inline MappedRegion map_pages(std::size_t bytes, PageMode want, bool lazy, bool populate, std::int32_t node) {
+    MappedRegion r;
+    while (want != PageMode::Small && page_bytes(want) > bytes) {
+        want = static_cast<PageMode>(static_cast<std::uint8_t>(want) - 1);
+    }
+    auto round = [bytes](std::size_t page) { return (bytes + page - 1) & ~(page - 1); };
+
+    #if defined(_WIN32)
+        (void)populate;
+        // Prefers the requested node; an invalid node falls back to the default placement.
+        auto alloc = [&](std::size_t len, DWORD type) {
+            if (node >= 0) {
+                r.ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, len, type, PAGE_READWRITE, static_cast<DWORD>(node));
+                if (r.ptr != nullptr) { r.node = node; return true; }
+            }
+            r.ptr = VirtualAlloc(nullptr, len, type, PAGE_READWRITE);
+            return r.ptr != nullptr;
+        };
+
+        // Large pages need SeLockMemoryPrivilege and are always committed; there is no 1 GiB
+        // or transparent variant, so those requests map to the nearest available mode.
+        if (want == PageMode::Huge1G || want == PageMode::Huge2M) {
+            std::size_t large = GetLargePageMinimum();
+            if (large != 0) {
+                std::size_t len = round(large);
+                if (alloc(len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES)) { r.bytes = len; r.mode = PageMode::Huge2M; return r; }
+            }
+        }
+        std::size_t len = round(4096);
+        if (alloc(len, lazy ? MEM_RESERVE : (MEM_RESERVE | MEM_COMMIT))) { r.bytes = len; r.mode = PageMode::Small; }
+        return r;
+    #else
+        (void)node;
+        const int base = MAP_PRIVATE | MAP_ANONYMOUS;
+        const int noreserve = lazy ? MAP_NORESERVE : 0;
+        #if defined(MAP_POPULATE)
+            const int fill = populate ? MAP_POPULATE : 0;
+        #else
+            const int fill = 0;
+            (void)populate;
+        #endif
+
+        #if defined(MAP_HUGETLB)
+            for (PageMode m : {PageMode::Huge1G, PageMode::Huge2M}) {
+                if (static_cast<std::uint8_t>(want) < static_cast<std::uint8_t>(m)) continue;
+                const int shift = (m == PageMode::Huge1G) ? 30 : 21;
+                std::size_t len = round(page_bytes(m));
+                void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                                 base | fill | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT), -1, 0);
+                if (p != MAP_FAILED) { r.ptr = p; r.bytes = len; r.mode = m; return r; }
+            }
+        #endif
+
+        #if defined(MADV_HUGEPAGE)
+            if (want != PageMode::Small) {
+                // Over-map by one huge page and trim, so the region starts on a 2 MiB boundary
+                // and every aligned 2 MiB run is eligible for promotion.
+                const std::size_t huge = page_bytes(PageMode::Transparent);
+                std::size_t len = round(huge);
+                void* p = ::mmap(nullptr, len + huge, PROT_READ | PROT_WRITE, base | noreserve, -1, 0);
+                if (p != MAP_FAILED) {
+                    std::uintptr_t raw = reinterpret_cast<std::uintptr_t>(p);
+                    std::uintptr_t aligned = (raw + huge - 1) & ~std::uintptr_t(huge - 1);
+                    if (aligned > raw) ::munmap(p, aligned - raw);
+                    if (raw + huge > aligned) ::munmap(reinterpret_cast<void*>(aligned + len), raw + huge - aligned);
+                    r.ptr = reinterpret_cast<void*>(aligned);
+                    r.bytes = len;
+                    // EINVAL here means THP is compiled out; the mapping is still usable.
+                    r.mode = ::madvise(r.ptr, len, MADV_HUGEPAGE) == 0 ? PageMode::Transparent : PageMode::Small;
+                    return r;
+                }
+            }
+        #endif
+
+        std::size_t len = round(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, base | noreserve | fill, -1, 0);
+        if (p != MAP_FAILED) { r.ptr = p; r.bytes = len; r.mode = PageMode::Small; }
+        return r;
+    #endif
+}
+
+/// \brief Write-faults every page of a mapping, splitting the range across `threads` threads.
+/// \details Stores a zero per page: the memory is still zero-filled, and a store (unlike a
+/// load, which maps the shared zero page) allocates the backing page.
+inline void touch_pages(void* ptr, std::size_t bytes, std::size_t page, std::uint32_t threads) {
+    volatile std::uint8_t* base = static_cast<std::uint8_t*>(ptr);
+    const std::size_t pages = bytes / page;
+    const std::size_t n = std::max<std::size_t>(1, std::min<std::size_t>(threads, pages));
+    const std::size_t chunk = (pages + n - 1) / n;
+    auto run = [=](std::size_t lo, std::size_t hi) {
+        for (std::size_t i = lo; i < hi; ++i) base[i * page] = 0;
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < n; ++t) pool.emplace_back(run, t * chunk, std::min(pages, (t + 1) * chunk));
+    run(0, std::min(pages, chunk));
+    for (auto& th : pool) th.join();
+}
+
+/// \brief NUMA node bitmask in the layout of the mbind / set_mempolicy syscalls.
+struct NodeMask {
+    static constexpr std::size_t WORD_BITS = 8 * sizeof(unsigned long);
+    /// maxnode argument: one past the last mask bit, matching the kernel's get_nodes().
+    static constexpr unsigned long MAXNODE = MAX_NUMA_NODE + 2;
+
+    unsigned long words[(MAX_NUMA_NODE + 1) / WORD_BITS] = {};
+
+    static NodeMask of(std::int32_t node) {
+        NodeMask m;
+        m.words[node / WORD_BITS] = 1ul << (node % WORD_BITS);
+        return m;
+    }
+};
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_set_mempolicy) && defined(SYS_get_mempolicy)
+    #define HYPERION_NUMA_SYSCALLS 1
+#endif
+
+/// \brief Binds the calling thread's allocations to one NUMA node for its lifetime (raw
+/// set_mempolicy, no libnuma), then restores the previous policy.
+/// \details Explicit huge pages are reserved at mmap time against the caller's policy, so
+/// mapping under this scope keeps the reservation on the node the pages will come from.
+class NodePolicyScope {
+public:
+    explicit NodePolicyScope(std::int32_t node) {
+        #if defined(HYPERION_NUMA_SYSCALLS)
+            if (node < 0) return;
+            NodeMask want = NodeMask::of(node);
+            active_ = ::syscall(SYS_get_mempolicy, &old_mode_, old_.words, NodeMask::MAXNODE, nullptr, 0ul) == 0 &&
+                      ::syscall(SYS_set_mempolicy, MPOL_BIND_MODE, want.words, NodeMask::MAXNODE) == 0;
+        #else
+            (void)node;
+        #endif
+    }
+    ~NodePolicyScope() {
+        #if defined(HYPERION_NUMA_SYSCALLS)
+            if (active_) ::syscall(SYS_set_mempolicy, old_mode_, old_.words, NodeMask::MAXNODE);
+        #endif
+    }
+    NodePolicyScope(const NodePolicyScope&) = delete;
+    NodePolicyScope& operator=(const NodePolicyScope&) = delete;
+
+    static constexpr int MPOL_BIND_MODE = 2; // <linux/mempolicy.h> MPOL_BIND
+
+private:
+    bool active_ = false;
+    int old_mode_ = 0;
+    NodeMask old_;
+};
+
+/// \brief Binds a fresh, untouched mapping to one NUMA node (raw mbind, no libnuma).
+/// \details MPOL_BIND makes every later fault allocate on `node`, whichever thread touches
+/// first. Fails (returns false) for nodes the kernel does not know or without NUMA syscalls.
+inline bool bind_node(void* ptr, std::size_t bytes, std::int32_t node) {
+    if (node < 0 || node > MAX_NUMA_NODE) return false;
+    #if defined(HYPERION_NUMA_SYSCALLS)
+        NodeMask mask = NodeMask::of(node);
+        return ::syscall(SYS_mbind, ptr, bytes, NodePolicyScope::MPOL_BIND_MODE, mask.words, NodeMask::MAXNODE, 0u) == 0;
+    #else
+        (void)ptr; (void)bytes;
+        return false;
+    #endif
+}
+
+/// \brief Maps a region per MemoryOptions: page size, NUMA placement, then residency.
+/// \details With numa_node set, the mapping is bound to that node before any page is touched;
+/// MappedRegion::node reports -1 if the binding was refused (the region is still usable).
+///
+/// With prefault or lock set, every page is backed before this returns: by MAP_POPULATE when
+/// prefault_threads is 0 (except Transparent, touched once the huge-page advice is in place,
+/// and NUMA-bound regions, which must be bound before the first fault), else by touch_pages().
+/// lock then pins the range; a lock the OS refuses (e.g. RLIMIT_MEMLOCK) leaves the region
+/// usable and reports locked == false.
+/// \param lazy Back base pages on demand when not resident (see map_pages()).
+inline MappedRegion map_region(std::size_t bytes, const MemoryOptions& opts, bool lazy) {
+    const bool resident = opts.resident();
+    const std::int32_t node = (opts.numa_node <= MAX_NUMA_NODE) ? opts.numa_node : -1;
+    const bool populate = resident && opts.prefault_threads == 0 && node < 0;
+    MappedRegion r;
+    {
+        NodePolicyScope scope(node);
+        r = map_pages(bytes, opts.pages, lazy && !resident, populate, node);
+    }
+    if (r.ptr == nullptr) return r;
+
+    #if !defined(_WIN32)
+        if (bind_node(r.ptr, r.bytes, node)) r.node = node;
+    #endif
+    if (!resident) return r;
+
+    #if defined(_WIN32) || !defined(MAP_POPULATE)
+        const bool populated = false;
+    #else
+        const bool populated = populate && r.mode != PageMode::Transparent;
+    #endif
+    if (!populated) {
+        const bool huge = r.mode == PageMode::Huge2M || r.mode == PageMode::Huge1G;
+        touch_pages(r.ptr, r.bytes, huge ? page_bytes(r.mode) : 4096, std::max(opts.prefault_threads, 1u));
+    }
+
+    if (opts.lock) {
+        #if defined(_WIN32)
+            r.locked = VirtualLock(r.ptr, r.bytes) != 0;
+        #else
+            r.locked = ::mlock(r.ptr, r.bytes) == 0;
+        #endif
+    }
+    return r;
+}
+
+inline void unmap_region(const MappedRegion& r) {
+    if (r.ptr == nullptr) return;
+    #if defined(_WIN32)
+        VirtualFree(r.ptr, 0, MEM_RELEASE);
+    #else
+        ::munmap(r.ptr, r.bytes);
+    #endif
+}
+
+/// \brief Outcome of map_file().
+enum class FileStatus { Created, Opened, SizeMismatch, Failed };
+
+/// \brief A file mapped shared, with the OS handles that keep it open.
+struct MappedFile {
+    MappedRegion map;
+    #if defined(_WIN32)
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE section = nullptr;
+    #else
+        int fd = -1;
+    #endif
+};
+
+/// \brief Maps the file at `path` shared (MAP_SHARED / MapViewOfFile), creating it `bytes` long
+/// if it is new or empty.
+/// \details Stores through the mapping land in the page cache and outlive the process;
+/// sync_file() makes them durable against power loss. A new file is sparse unless the options ask
+/// for residency, in which case its disk blocks are reserved up front (posix_fallocate), so a full
+/// disk cannot fault a later store with SIGBUS. File mappings always use base pages and are never
+/// NUMA bound: page cache placement belongs to the kernel. prefault reads the file in
+/// (MAP_POPULATE, prefault_threads is ignored) and lock pins it.
+/// \return SizeMismatch if an existing file is not exactly `bytes` long (nothing is mapped).
+inline FileStatus map_file(const char* path, std::size_t bytes, const MemoryOptions& opts, MappedFile& out) {
+    out = MappedFile{};
+    const bool resident = opts.resident();
+
+    #if defined(_WIN32)
+        HANDLE h = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                               nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE) return FileStatus::Failed;
+        LARGE_INTEGER have{};
+        if (!GetFileSizeEx(h, &have)) { CloseHandle(h); return FileStatus::Failed; }
+        const bool fresh = have.QuadPart == 0;
+        if (!fresh && static_cast<std::uint64_t>(have.QuadPart) != bytes) { CloseHandle(h); return FileStatus::SizeMismatch; }
+
+        // The section extends a new file to `bytes`; its pages are committed against the file.
+        const std::uint64_t len = bytes;
+        HANDLE s = CreateFileMappingA(h, nullptr, PAGE_READWRITE, static_cast<DWORD>(len >> 32), static_cast<DWORD>(len), nullptr);
+        if (s == nullptr) { CloseHandle(h); return FileStatus::Failed; }
+        void* p = MapViewOfFile(s, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+        if (p == nullptr) { CloseHandle(s); CloseHandle(h); return FileStatus::Failed; }
+        out.file = h;
+        out.section = s;
+        out.map.ptr = p;
+        out.map.bytes = bytes;
+        out.map.shared = true;
+        if (opts.lock) out.map.locked = VirtualLock(p, bytes) != 0;
+    #else
+        int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return FileStatus::Failed;
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) { ::close(fd); return FileStatus::Failed; }
+        const bool fresh = st.st_size == 0;
+        if (!fresh && static_cast<std::uint64_t>(st.st_size) != bytes) { ::close(fd); return FileStatus::SizeMismatch; }
+        if (fresh) {
+            const bool sized = resident ? ::posix_fallocate(fd, 0, static_cast<off_t>(bytes)) == 0
+                                        : ::ftruncate(fd, static_cast<off_t>(bytes)) == 0;
+            if (!sized) { ::close(fd); return FileStatus::Failed; }
+        }
+
+        #if defined(MAP_POPULATE)
+            const int fill = resident ? MAP_POPULATE : 0;
+        #else
+            const int fill = 0;
+        #endif
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | fill, fd, 0);
+        if (p == MAP_FAILED) { ::close(fd); return FileStatus::Failed; }
+        out.fd = fd;
+        out.map.ptr = p;
+        out.map.bytes = bytes;
+        out.map.shared = true;
+        if (opts.lock) out.map.locked = ::mlock(p, bytes) == 0;
+    #endif
+    return fresh ? FileStatus::Created : FileStatus::Opened;
+}
+
+/// \brief Flushes dirty pages of [ptr, ptr + bytes) within a mapped file to disk and waits.
+inline bool sync_file(const MappedFile& f, void* ptr, std::size_t bytes) {
+    if (f.map.ptr == nullptr) return false;
+    #if defined(_WIN32)
+        return FlushViewOfFile(ptr, bytes) != 0 && FlushFileBuffers(f.file) != 0;
+    #else
+        // msync wants a page-aligned start.
+        const std::uintptr_t page = 4096;
+        std::uintptr_t lo = reinterpret_cast<std::uintptr_t>(ptr) & ~(page - 1);
+        std::uintptr_t hi = reinterpret_cast<std::uintptr_t>(ptr) + bytes;
+        return ::msync(reinterpret_cast<void*>(lo), hi - lo, MS_SYNC) == 0;
+    #endif
+}
+
+/// \brief Unmaps a file and closes its handles. Unsynced stores still reach the file eventually.
+inline void unmap_file(MappedFile& f) {
+    #if defined(_WIN32)
+        if (f.map.ptr) UnmapViewOfFile(f.map.ptr);
+        if (f.section) CloseHandle(f.section);
+        if (f.file != INVALID_HANDLE_VALUE) CloseHandle(f.file);
+    #else
+        if (f.map.ptr) ::munmap(f.map.ptr, f.map.bytes);
+        if (f.fd >= 0) ::close(f.fd);
+    #endif
+    f = MappedFile{};
+}
+
+/// \brief Creates (`create`) or attaches to the named shared-memory object `name` and maps it shared.
+/// \details The creator replaces any object of that name (processes that mapped the old one keep
+/// it), sizes the new one to `bytes` and maps it read-write; prefault and lock apply as in map_file().
+/// Other processes attach with `create` false: the whole object is mapped read-only, `bytes` is
+/// ignored and out.map.bytes reports its size. POSIX names are "/name" (shm_open); Windows uses a
+/// named, pagefile-backed section that lives while any process holds it.
+inline bool map_shared(const char* name, std::size_t bytes, bool create, const MemoryOptions& opts, MappedFile& out) {
+    out = MappedFile{};
+
+    #if defined(_WIN32)
+        HANDLE s = create
+            ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                 static_cast<DWORD>(static_cast<std::uint64_t>(bytes) >> 32), static_cast<DWORD>(bytes), name)
+            : OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+        if (s == nullptr) return false;
+        void* p = MapViewOfFile(s, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, create ? bytes : 0);
+        if (p == nullptr) { CloseHandle(s); return false; }
+        if (!create) {
+            MEMORY_BASIC_INFORMATION info{};
+            VirtualQuery(p, &info, sizeof(info));
+            bytes = info.RegionSize;
+        }
+        out.section = s;
+    #else
+        if (create) ::shm_unlink(name);
+        int fd = create ? ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) : ::shm_open(name, O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st{};
+        const bool sized = create ? ::ftruncate(fd, static_cast<off_t>(bytes)) == 0 : ::fstat(fd, &st) == 0;
+        if (!sized) {
+            ::close(fd);
+            if (create) ::shm_unlink(name);
+            return false;
+        }
+        if (!create) bytes = static_cast<std::size_t>(st.st_size);
+
+        #if defined(MAP_POPULATE)
+            const int fill = create && opts.resident() ? MAP_POPULATE : 0;
+        #else
+            const int fill = 0;
+        #endif
+        void* p = bytes == 0 ? MAP_FAILED : ::mmap(nullptr, bytes, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED | fill, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            if (create) ::shm_unlink(name);
+            return false;
+        }
+        out.fd = fd;
+    #endif
+    out.map.ptr = p;
+    out.map.bytes = bytes;
+    out.map.shared = true;
+    if (create && opts.lock) {
+        #if defined(_WIN32)
+            out.map.locked = VirtualLock(p, bytes) != 0;
+        #else
+            out.map.locked = ::mlock(p, bytes) == 0;
+        #endif
+    }
+    return true;
+}
+
+/// \brief Removes the name of a shared-memory object; processes that mapped it keep their view.
+inline void unlink_shared(const char* name) {
+    #if defined(_WIN32)
+        (void)name; // The section goes with its last handle.
+    #else
+        ::shm_unlink(name);
+    #endif
+}
+
+/// \brief Owning, fixed-size array of T placed according to MemoryOptions (index slot arrays).
+/// \details With default options it is a plain heap array, exactly like std::make_unique<T[]>;
+/// huge pages, locking or NUMA binding map a dedicated region. Elements start zero-initialized either way.
+/// The indexes write every slot in init(), so index memory is always faulted in up front.
+/// A borrowed array views caller memory (e.g. a shared-memory region) and never frees it.
+/// Throws std::bad_alloc if no memory could be obtained.
+/// \tparam T Trivially destructible element type.
+template <typename T>
+class PageArray {
+    static_assert(std::is_trivially_destructible_v<T>, "PageArray never runs element destructors");
+
+public:
+    PageArray() = default;
+
+    PageArray(std::size_t n, const MemoryOptions& opts) {
+        if (opts.pages == PageMode::Small && !opts.lock && opts.numa_node < 0) {
+            ptr_ = new T[n]();
+            return;
+        }
+        map_ = map_region(n * sizeof(T), opts, false);
+        if (map_.ptr == nullptr) throw std::bad_alloc();
+        ptr_ = static_cast<T*>(map_.ptr);
+    }
+
+    /// \brief Borrows the elements at `p`, which the caller keeps mapped for the array's lifetime.
+    static PageArray borrow(T* p) {
+        PageArray a;
+        a.ptr_ = p;
+        a.borrowed_ = true;
+        return a;
+    }
+
+    ~PageArray() { release(); }
+
+    PageArray(PageArray&& o) noexcept
+        : ptr_(std::exchange(o.ptr_, nullptr)), map_(std::exchange(o.map_, {})), borrowed_(std::exchange(o.borrowed_, false)) {}
+    PageArray& operator=(PageArray&& o) noexcept {
+        if (this != &o) {
+            release();
+            ptr_ = std::exchange(o.ptr_, nullptr);
+            map_ = std::exchange(o.map_, {});
+            borrowed_ = std::exchange(o.borrowed_, false);
+        }
+        return *this;
+    }
+    PageArray(const PageArray&) = delete;
+    PageArray& operator=(const PageArray&) = delete;
+
+    T& operator[](std::size_t i) { return ptr_[i]; }
+    const T& operator[](std::size_t i) const { return ptr_[i]; }
+    T* get() const { return ptr_; }
+
+    /// \brief Page size actually backing the array.
+    PageMode mode() const { return map_.ptr ? map_.mode : PageMode::Small; }
+
+    /// \brief True if the array is pinned in RAM.
+    bool locked() const { return map_.locked; }
+
+    /// \brief NUMA node the array is bound to, -1 if unbound.
+    std::int32_t numa_node() const { return map_.node; }
+
+private:
+    void release() {
+        if (map_.ptr) unmap_region(map_);
+        else if (!borrowed_) delete[] ptr_;
+        ptr_ = nullptr;
+        map_ = {};
+        borrowed_ = false;
+    }
+
+    T* ptr_ = nullptr;
+    MappedRegion map_;
+    bool borrowed_ = false; // Caller memory: release() leaves it alone.
+};
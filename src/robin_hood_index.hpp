@@ -0,0 +1,199 @@
+#pragma once
+
+#include "index.hpp"
+#include <bit>
+
+/// \brief Open-Addressing Hash Index with Robin Hood probing and backward-shift deletion.
+///
+/// \details
+/// A dense side array stores each slot's probe distance (0 = Empty, d = d-1 slots from home).
+/// Entries within a cluster stay ordered by home position, which gives two properties:
+///   - Lookups stop as soon as they meet a resident closer to its home than the probe is.
+///   - Deletes shift the tail of the cluster back by one, so no tombstones ever exist and
+///     probe lengths do not degrade under insert/delete churn.
+///
+/// Drop-in replacement for Index: exposes the same find/update/insert/erase/at contract.
+/// \tparam SlotT Slot layout: Slot (16-byte) or CompactSlot (8-byte).
+template <typename SlotT = Slot>
+class BasicRobinHoodIndex {
+public:
+    using slot_type = SlotT;
+
+    /// Probe distances are stored in one byte; inserts that would exceed this report Full.
+    static constexpr std::uint32_t MAX_DIST = 255;
+    /// Position find_in() returns when the key must be resolved by find() instead.
+    static constexpr std::uint32_t NPOS = UINT32_MAX;
+
+    BasicRobinHoodIndex() = default;
+
+    // Move-only resource management
+    BasicRobinHoodIndex(BasicRobinHoodIndex&&) = default;
+    BasicRobinHoodIndex& operator=(BasicRobinHoodIndex&&) = default;
+    BasicRobinHoodIndex(const BasicRobinHoodIndex&) = delete;
+    BasicRobinHoodIndex& operator=(const BasicRobinHoodIndex&) = delete;
+
+    /// \brief Page placement for the slot and side arrays (call before init()).
+    void set_memory(const MemoryOptions& mem) { mem_ = mem; }
+
+    /// \brief Page size backing the slot array.
+    PageMode page_mode() const { return slots_.mode(); }
+
+    /// \brief True if the slot and side arrays are pinned in RAM.
+    bool locked() const { return slots_.locked() && dist_.locked(); }
+
+    /// \brief NUMA node both arrays are bound to, -1 if unbound.
+    std::int32_t numa_node() const { return slots_.numa_node() == dist_.numa_node() ? slots_.numa_node() : -1; }
+
+    void init(std::uint32_t slots) {
+        capacity_ = std::bit_ceil(std::max(slots, 8u));
+        mask_ = capacity_ - 1;
+        slots_ = PageArray<SlotT>(capacity_, mem_);
+        dist_ = PageArray<std::uint8_t>(capacity_, mem_);
+        for(std::uint32_t i=0; i<capacity_; ++i) slots_[i] = SlotT::empty();
+        std::memset(dist_.get(), 0, capacity_);
+    }
+
+    /// Identifies the init_shared() layout to processes attaching to it.
+    static constexpr std::uint32_t SHARED_KIND = 3;
+
+    /// \brief Bytes init_shared() places for `slots`: the slots, then the probe distances.
+    static std::size_t shared_bytes(std::uint32_t slots) {
+        return std::size_t(std::bit_ceil(std::max(slots, 8u))) * (sizeof(SlotT) + 1);
+    }
+
+    /// \brief init() over shared_bytes(slots) of caller memory (64-byte aligned), e.g. a shared-memory region.
+    /// \details `fresh` empties the table; otherwise it is adopted as found, by a process attaching
+    /// to a table another one writes.
+    void init_shared(std::uint32_t slots, void* mem, bool fresh) {
+        capacity_ = std::bit_ceil(std::max(slots, 8u));
+        mask_ = capacity_ - 1;
+        auto* bytes = static_cast<std::uint8_t*>(mem);
+        slots_ = PageArray<SlotT>::borrow(reinterpret_cast<SlotT*>(bytes));
+        dist_ = PageArray<std::uint8_t>::borrow(bytes + std::size_t(capacity_) * sizeof(SlotT));
+        if (fresh) {
+            for(std::uint32_t i=0; i<capacity_; ++i) slots_[i] = SlotT::empty();
+            std::memset(dist_.get(), 0, capacity_);
+        }
+    }
+
+    /// \brief Robin Hood Lookup.
+    /// \param eq Functor for deep key comparison.
+    /// \return Pair {Index, Found}. If !Found, Index is the insertion candidate.
+    template <typename KeyEq>
+    std::pair<std::uint32_t, bool> find(std::uint32_t h, std::size_t klen, KeyEq&& eq) const {
+        std::uint8_t tag = static_cast<std::uint8_t>(h >> 24);
+        std::uint32_t idx = h & mask_;
+
+        for(std::uint32_t d=1; d<=MAX_DIST; ++d) {
+            // Empty (0) or a resident richer than us: the key cannot live further along.
+            if (dist_[idx] < d) return {idx, false};
+
+            const SlotT& s = slots_[idx];
+            if (s.hash_tag == tag && s.key_len == klen && eq(s)) return {idx, true};
+
+            idx = (idx + 1) & mask_;
+        }
+        return {idx, false};
+    }
+
+    /// \brief Overwrites an existing entry (idx returned by a successful find).
+    void update(std::uint32_t idx, std::uint8_t tag, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        slots_[idx] = SlotT::make(tag, klen, vlen, ref);
+    }
+
+    /// \brief Inserts a new entry at the candidate returned by an unsuccessful find.
+    /// \details Shifts the rest of the cluster forward by one slot. Validates the whole
+    /// shift before mutating, so a Full result leaves the table untouched.
+    /// \return false if no Empty slot is reachable within MAX_DIST.
+    bool insert(std::uint32_t idx, std::uint32_t h, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        std::uint32_t d = ((idx - h) & mask_) + 1;
+        if (d > MAX_DIST) return false;
+
+        // Locate the end of the cluster; every shifted resident gains one step of distance.
+        std::uint32_t end = idx;
+        for(std::uint32_t n=0; dist_[end] != 0; ++n) {
+            if (n == capacity_ || dist_[end] == MAX_DIST) return false;
+            end = (end + 1) & mask_;
+        }
+
+        while (end != idx) {
+            std::uint32_t prev = (end - 1) & mask_;
+            slots_[end] = slots_[prev];
+            dist_[end] = static_cast<std::uint8_t>(dist_[prev] + 1);
+            end = prev;
+        }
+        slots_[idx] = SlotT::make(static_cast<std::uint8_t>(h >> 24), klen, vlen, ref);
+        dist_[idx] = static_cast<std::uint8_t>(d);
+        return true;
+    }
+
+    /// \brief Removes the entry at idx via backward-shift: no tombstone is left behind.
+    void erase(std::uint32_t idx) {
+        std::uint32_t next = (idx + 1) & mask_;
+        // Pull displaced successors one slot closer to home until an Empty or home-resident slot.
+        while (dist_[next] > 1) {
+            slots_[idx] = slots_[next];
+            dist_[idx] = static_cast<std::uint8_t>(dist_[next] - 1);
+            idx = next;
+            next = (next + 1) & mask_;
+        }
+        slots_[idx] = SlotT::empty();
+        dist_[idx] = 0;
+    }
+
+    /// \brief find() confined to the slots [h & mask(), hi), for parallel builds over disjoint ranges.
+    /// \details A candidate is only offered if the cluster shift insert() performs ends inside
+    /// the range as well.
+    /// \return {idx, found} as find(), or {NPOS, false} if the probe or the shift leaves the range.
+    template <typename KeyEq>
+    std::pair<std::uint32_t, bool> find_in(std::uint32_t hi, std::uint32_t h, std::size_t klen, KeyEq&& eq) const {
+        const std::uint8_t tag = static_cast<std::uint8_t>(h >> 24);
+        std::uint32_t idx = h & mask_;
+        for(std::uint32_t d=1; d<=MAX_DIST && idx < hi; ++d, ++idx) {
+            if (dist_[idx] < d) {
+                for(std::uint32_t end = idx; end < hi && dist_[end] != MAX_DIST; ++end) {
+                    if (dist_[end] == 0) return {idx, false};
+                }
+                return {NPOS, false};
+            }
+            const SlotT& s = slots_[idx];
+            if (s.hash_tag == tag && s.key_len == klen && eq(s)) return {idx, true};
+        }
+        return {NPOS, false};
+    }
+
+    /// \brief Stores a new entry at a candidate from find_in(); the shift stays inside its range.
+    void insert_in(std::uint32_t idx, std::uint32_t h, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        insert(idx, h, klen, vlen, ref);
+    }
+
+    /// \brief Nothing to account: occupancy lives in the distance array.
+    void bulk_done(std::uint32_t) {}
+
+    /// \brief Fixed capacity: nothing to migrate.
+    template <typename HashOf>
+    void migrate(HashOf&&) {}
+
+    /// \brief Inserts and erases shift neighbouring entries, so writes are always structural.
+    bool local_writes() const { return false; }
+
+    /// \brief Prefetches the home bucket's distance byte and Slot.
+    void prefetch(std::uint32_t h) const {
+        prefetch_line(&dist_[h & mask_]);
+        prefetch_line(&slots_[h & mask_]);
+    }
+
+    SlotT& at(std::uint32_t idx) { return slots_[idx]; }
+    const SlotT& at(std::uint32_t idx) const { return slots_[idx]; }
+    std::uint32_t cap() const { return capacity_; }
+    std::uint32_t mask() const { return mask_; }
+
+private:
+    PageArray<SlotT> slots_;
+    PageArray<std::uint8_t> dist_;
+    MemoryOptions mem_;
+    std::uint32_t capacity_ = 0;
+    std::uint32_t mask_ = 0;
+};
+
+using RobinHoodIndex = BasicRobinHoodIndex<>;
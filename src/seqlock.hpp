@@ -2,6 +2,10 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -11,6 +15,15 @@
     #include <immintrin.h> 
 #endif
 
+/// \brief Spin-wait hint to reduce bus contention (`_mm_pause` / `yield`).
+inline void cpu_relax() {
+    #if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+    #elif defined(__aarch64__)
+        asm volatile("yield");
+    #endif
+}
+
 /// \brief A Single-Writer / Multi-Reader Optimistic Lock.
 /// 
 /// \details
@@ -40,34 +53,43 @@ public:
     template <typename F>
     auto read(F&& f) const -> decltype(f(std::declval<const T&>())) {
         for (;;) {
-            // Load Version (Acquire): Ensures we see latest updates before speculative read.
-            std::uint64_t v1 = seq_.load(std::memory_order_acquire);
-            
-            // If odd, a write is in progress. Spin-wait to reduce bus contention.
-            if (v1 & 1) {
-                #if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
-                    _mm_pause();
-                #elif defined(__aarch64__)
-                    asm volatile("yield");
-                #endif
-                continue;
-            }
+            std::uint64_t v = read_begin();
 
             // Speculative Read Critical Section.
             auto result = f(data_);
 
-            // LoadLoad Fence: Prevents the CPU/Compiler from reordering the 'seq_' check (v2)
-            // before the data read 'f(data_)'. Essential on weak memory models (ARM/POWER).
-            std::atomic_thread_fence(std::memory_order_acquire);
-
-            // Validate consistency.
-            std::uint64_t v2 = seq_.load(std::memory_order_relaxed);
-            if (v1 == v2) {
+            if (validate(v)) {
                 return result;
             }
         }
     }
 
+    /// \brief Opens a manual read section (for results that outlive a read() lambda).
+    /// \return Even version to pass to validate().
+    std::uint64_t read_begin() const {
+        for (;;) {
+            // Load Version (Acquire): Ensures we see latest updates before speculative read.
+            std::uint64_t v = seq_.load(std::memory_order_acquire);
+            if ((v & 1) == 0) return v;
+
+            // If odd, a write is in progress. Spin-wait to reduce bus contention.
+            cpu_relax();
+        }
+    }
+
+    /// \brief Closes a manual read section.
+    /// \return true if no write started since read_begin() returned v.
+    bool validate(std::uint64_t v) const {
+        // LoadLoad Fence: Prevents the CPU/Compiler from reordering the 'seq_' check
+        // before the data reads. Essential on weak memory models (ARM/POWER).
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) == v;
+    }
+
+    /// \brief Unsynchronized view of the data for manual read sections.
+    /// \warning Anything derived from it is speculative until validate() succeeds.
+    const T& peek() const { return data_; }
+
     /// \brief Exclusive write transaction.
     /// \details Only one writer thread is allowed at a time. This is asserted, not enforced.
     template <typename F>
@@ -90,4 +112,128 @@ public:
 private:
     std::atomic<std::uint64_t> seq_;
     T data_;
-};
\ No newline at end of file
+};
+
+/// \brief Read-section token of a StripedSeqLock: the structural and stripe versions observed.
+struct StripeVersion {
+    std::uint64_t global = 0;
+    std::uint64_t stripe = 0;
+    std::uint32_t index = 0;
+};
+
+/// \brief Single-Writer / Multi-Reader Optimistic Lock with per-stripe sequence counters.
+///
+/// \details
+/// Keys are partitioned into STRIPES by hash, each with its own cache-line-padded counter,
+/// plus one structural counter. A keyed write bumps only its stripe, so readers of other
+/// stripes never retry. Writes that may relocate other keys (resizes, shifts, batches)
+/// use the structural counter, which invalidates every reader as a plain SeqLock would.
+///
+/// Keyed writes are only sound when they modify nothing a reader of another stripe depends on
+/// (e.g. a single slot store in linear or group probing); the caller is responsible for
+/// choosing structural writes otherwise.
+///
+/// The counters can live in caller memory instead of the heap (see COUNTER_BYTES), so a lock in a
+/// shared-memory region guards readers in other processes exactly as it guards local threads.
+///
+/// \tparam T The data protected by the lock.
+/// \tparam STRIPES Number of stripe counters (power of two).
+template <typename T, std::uint32_t STRIPES = 1024>
+class StripedSeqLock {
+    static_assert((STRIPES & (STRIPES - 1)) == 0, "STRIPES must be a power of two");
+
+public:
+    /// Bytes of caller memory the counters occupy (64-byte aligned; see the placing constructor).
+    static constexpr std::size_t COUNTER_BYTES = (STRIPES + 1) * 64;
+
+    StripedSeqLock() : owned_(new Stripe[STRIPES + 1]), data_{} { counters_ = owned_.get(); }
+    explicit StripedSeqLock(T&& initial) : owned_(new Stripe[STRIPES + 1]), data_(std::move(initial)) {
+        counters_ = owned_.get();
+    }
+
+    /// \brief Places the counters in COUNTER_BYTES of caller memory, e.g. a shared-memory region.
+    /// \details `fresh` starts them at zero; otherwise they are adopted as found, as by a process
+    /// attaching to a lock another process writes. The memory must outlive the lock.
+    StripedSeqLock(T&& initial, void* counters, bool fresh) : data_(std::move(initial)) {
+        auto* c = static_cast<Stripe*>(counters);
+        if (fresh) {
+            for (std::uint32_t i = 0; i <= STRIPES; ++i) new (c + i) Stripe();
+        }
+        counters_ = std::launder(c);
+    }
+
+    StripedSeqLock(const StripedSeqLock&) = delete;
+    StripedSeqLock& operator=(const StripedSeqLock&) = delete;
+
+    static std::uint32_t stripe_of(std::uint32_t h) { return h & (STRIPES - 1); }
+
+    /// \brief Optimistic read of the key hashing to h. Retries only on writes to its stripe
+    /// or on structural writes.
+    template <typename F>
+    auto read(std::uint32_t h, F&& f) const -> decltype(f(std::declval<const T&>())) {
+        for (;;) {
+            StripeVersion v = read_begin(h);
+            auto result = f(data_);
+            if (validate(v)) {
+                return result;
+            }
+        }
+    }
+
+    /// \brief Opens a manual read section for the key hashing to h.
+    StripeVersion read_begin(std::uint32_t h) const {
+        StripeVersion v;
+        v.index = stripe_of(h);
+        for (;;) {
+            v.global = counters_[0].seq.load(std::memory_order_acquire);
+            v.stripe = counters_[1 + v.index].seq.load(std::memory_order_acquire);
+            if (((v.global | v.stripe) & 1) == 0) return v;
+            cpu_relax();
+        }
+    }
+
+    /// \brief Closes a manual read section.
+    /// \return true if neither the stripe nor the structure changed since read_begin().
+    bool validate(const StripeVersion& v) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return counters_[1 + v.index].seq.load(std::memory_order_relaxed) == v.stripe &&
+               counters_[0].seq.load(std::memory_order_relaxed) == v.global;
+    }
+
+    /// \brief Unsynchronized view of the data for manual read sections.
+    const T& peek() const { return data_; }
+
+    /// \brief Keyed write: invalidates readers of h's stripe only.
+    template <typename F>
+    void write(std::uint32_t h, F&& f) {
+        std::atomic<std::uint64_t>& seq = counters_[1 + stripe_of(h)].seq;
+        std::uint64_t prev = seq.fetch_add(1, std::memory_order_acquire);
+        assert((prev & 1) == 0 && "Concurrent writers detected! StripedSeqLock requires external write serialization.");
+        f(data_);
+        seq.store(prev + 2, std::memory_order_release);
+    }
+
+    /// \brief Structural write: invalidates every reader.
+    template <typename F>
+    void write(F&& f) {
+        std::atomic<std::uint64_t>& global = counters_[0].seq;
+        std::uint64_t prev = global.fetch_add(1, std::memory_order_acquire);
+        assert((prev & 1) == 0 && "Concurrent writers detected! StripedSeqLock requires external write serialization.");
+        f(data_);
+        global.store(prev + 2, std::memory_order_release);
+    }
+
+private:
+    // One counter per cache line: writers to one stripe never false-share with readers of another.
+    struct alignas(64) Stripe {
+        std::atomic<std::uint64_t> seq{0};
+    };
+
+    static_assert(sizeof(Stripe) == 64 && std::atomic<std::uint64_t>::is_always_lock_free,
+                  "Counters must be address-free 64-bit words to be shared across processes");
+
+    // The structural counter, then one per stripe: heap-owned, or placed in caller memory.
+    Stripe* counters_ = nullptr;
+    std::unique_ptr<Stripe[]> owned_;
+    T data_;
+};
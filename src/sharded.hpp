@@ -0,0 +1,203 @@
+#pragma once
+
+#include "hyperion.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+/// \brief Hash-partitioned set of independent Hyperion engines (multi-writer).
+///
+/// \details
+/// Each shard owns its own Arena, Index and StripedSeqLock, allocated separately so no two
+/// shards share a cache line. Keys are routed by a remix of the engine hash (hash_mix32), so
+/// the bits used for shard selection stay independent of the bucket and tag bits used inside
+/// a shard. The hash is computed once and handed to the shard via HashedKey.
+///
+/// Writers to different shards proceed in parallel. Each shard carries a writer spinlock, so
+/// any thread may write any key; feeds that partition their keys by shard_of() never contend.
+/// Readers are lock-free exactly as in BasicHyperion, and the key-level API (string, binary and
+/// integral keys, get_view/validate, multi_get) matches it, so either serves as a drop-in.
+template <typename IndexT = Index, typename HashT = Fnv1a>
+class BasicShardedHyperion {
+public:
+    using Engine = BasicHyperion<IndexT, HashT>;
+
+    BasicShardedHyperion() = default;
+
+    /// \brief Creates `shards` engines of `bytes_per_shard` Arena and `slots_per_shard` slots each.
+    static BasicShardedHyperion create(std::uint32_t shards, std::size_t bytes_per_shard,
+                                       std::uint32_t slots_per_shard, ArenaError& ae,
+                                       const MemoryOptions& mem = {}) {
+        BasicShardedHyperion db;
+        ae = ArenaError::None;
+        db.shards_.reserve(shards);
+        for (std::uint32_t i = 0; i < shards; ++i) {
+            db.shards_.push_back(std::make_unique<Shard>(bytes_per_shard, slots_per_shard, ae, mem));
+            if (ae != ArenaError::None) return BasicShardedHyperion();
+        }
+        return db;
+    }
+
+    std::uint32_t shard_count() const { return static_cast<std::uint32_t>(shards_.size()); }
+
+    /// \brief Shard owning `key`. Writers pinned to one shard each never contend.
+    std::uint32_t shard_of(std::string_view key) const { return route(Engine::hashed(key)); }
+
+    /// \brief Direct access to one shard's engine (e.g. for batched or zero-copy APIs).
+    /// \warning Writes through this reference bypass the shard writer lock.
+    Engine& shard(std::uint32_t i) { return shards_[i]->db; }
+    const Engine& shard(std::uint32_t i) const { return shards_[i]->db; }
+
+    /// \brief Thread-safe Put (Multi-Writer): serialized per shard only.
+    Status put(std::string_view key, std::string_view val) {
+        HashedKey hk = Engine::hashed(key);
+        Shard& s = *shards_[route(hk)];
+        WriterGuard g(s.writer);
+        return s.db.put(hk, val);
+    }
+
+    /// \brief Thread-safe Delete (Multi-Writer): serialized per shard only.
+    Status del(std::string_view key) {
+        HashedKey hk = Engine::hashed(key);
+        Shard& s = *shards_[route(hk)];
+        WriterGuard g(s.writer);
+        return s.db.del(hk);
+    }
+
+    /// \brief Lock-free Get (Multi-Reader).
+    Status get(std::string_view key, std::string& out_val) const {
+        HashedKey hk = Engine::hashed(key);
+        return shards_[route(hk)]->db.get(hk, out_val);
+    }
+
+    /// \brief Allocation-free Get into a caller-owned buffer (Multi-Reader).
+    Status get(std::string_view key, std::span<char> buf, std::size_t& len) const {
+        HashedKey hk = Engine::hashed(key);
+        return shards_[route(hk)]->db.get(hk, buf, len);
+    }
+
+    /// \brief Visitor Get (Multi-Reader). See BasicHyperion::get_with for retry semantics.
+    template <typename Fn>
+    Status get_with(std::string_view key, Fn&& fn) const {
+        HashedKey hk = Engine::hashed(key);
+        return shards_[route(hk)]->db.get_with(hk, std::forward<Fn>(fn));
+    }
+
+    /// \brief Zero-copy Get (Multi-Reader). Check the view with validate() after using it.
+    Status get_view(std::string_view key, ValueView& out) const {
+        HashedKey hk = Engine::hashed(key);
+        return shards_[route(hk)]->db.get_view(hk, out);
+    }
+
+    /// \brief BasicHyperion::validate() on the shard that resolved the view.
+    bool validate(const ValueView& view) const {
+        for (const auto& s : shards_) {
+            if (s->db.owns(view)) return s->db.validate(view);
+        }
+        return false;
+    }
+
+    /// \brief Batched zero-copy Get (Multi-Reader). Same contract as BasicHyperion::multi_get().
+    /// \details Keys are hashed once, grouped by shard per batch of Engine::MULTI_GET_BATCH,
+    /// and each group goes through its shard's prefetching multi_get().
+    std::size_t multi_get(std::span<const std::string_view> keys, std::span<ValueView> out, std::span<Status> status) const {
+        constexpr std::size_t B = Engine::MULTI_GET_BATCH;
+        std::size_t found = 0;
+        HashedKey hks[B];
+        std::uint32_t owner[B];
+        std::uint32_t order[B];
+        ValueView views[B];
+        Status sts[B];
+
+        for (std::size_t base = 0; base < keys.size(); base += B) {
+            const std::size_t n = std::min(B, keys.size() - base);
+            for (std::size_t i = 0; i < n; ++i) {
+                hks[i] = Engine::hashed(keys[base + i]);
+                owner[i] = route(hks[i]);
+                order[i] = static_cast<std::uint32_t>(i);
+            }
+            std::sort(order, order + n, [&](std::uint32_t a, std::uint32_t b) { return owner[a] < owner[b]; });
+
+            for (std::size_t lo = 0; lo < n;) {
+                const std::uint32_t shard = owner[order[lo]];
+                std::size_t hi = lo;
+                HashedKey group[B];
+                for (; hi < n && owner[order[hi]] == shard; ++hi) group[hi - lo] = hks[order[hi]];
+                found += shards_[shard]->db.multi_get(std::span<const HashedKey>(group, hi - lo), views, sts);
+                for (std::size_t j = lo; j < hi; ++j) {
+                    if (sts[j - lo] == Status::OK) out[base + order[j]] = views[j - lo];
+                    status[base + order[j]] = sts[j - lo];
+                }
+                lo = hi;
+            }
+        }
+        return found;
+    }
+
+    // Binary Key/Value Overloads (std::byte spans).
+    Status put(std::span<const std::byte> key, std::span<const std::byte> val) {
+        return put(as_chars(key), as_chars(val));
+    }
+    Status get(std::span<const std::byte> key, std::span<std::byte> buf, std::size_t& len) const {
+        return get(as_chars(key), std::span<char>((char*)buf.data(), buf.size()), len);
+    }
+    Status del(std::span<const std::byte> key) {
+        return del(as_chars(key));
+    }
+
+    // Integral Key Overloads (encoded via IntKey, as in BasicHyperion).
+    template <std::integral K>
+    Status put(K key, std::string_view val) { return put(IntKey(key).view(), val); }
+    template <std::integral K>
+    Status get(K key, std::string& out_val) const { return get(IntKey(key).view(), out_val); }
+    template <std::integral K>
+    Status get(K key, std::span<char> buf, std::size_t& len) const { return get(IntKey(key).view(), buf, len); }
+    template <std::integral K, typename Fn>
+    Status get_with(K key, Fn&& fn) const { return get_with(IntKey(key).view(), std::forward<Fn>(fn)); }
+    template <std::integral K>
+    Status get_view(K key, ValueView& out) const { return get_view(IntKey(key).view(), out); }
+    template <std::integral K>
+    Status del(K key) { return del(IntKey(key).view()); }
+
+private:
+    /// \brief Spin guard for a shard's writer flag (uncontended: one atomic exchange).
+    class WriterGuard {
+    public:
+        explicit WriterGuard(std::atomic<bool>& f) : f_(f) {
+            while (f_.exchange(true, std::memory_order_acquire)) {
+                while (f_.load(std::memory_order_relaxed)) cpu_relax();
+            }
+        }
+        ~WriterGuard() { f_.store(false, std::memory_order_release); }
+        WriterGuard(const WriterGuard&) = delete;
+        WriterGuard& operator=(const WriterGuard&) = delete;
+
+    private:
+        std::atomic<bool>& f_;
+    };
+
+    struct alignas(64) Shard {
+        Shard(std::size_t bytes, std::uint32_t slots, ArenaError& ae, const MemoryOptions& mem)
+            : db(Engine::create(bytes, slots, ae, ArenaMode::Monotonic, mem)) {}
+
+        alignas(64) std::atomic<bool> writer{false};
+        alignas(64) Engine db;
+    };
+
+    static std::string_view as_chars(std::span<const std::byte> b) {
+        return {(const char*)b.data(), b.size()};
+    }
+
+    std::uint32_t route(const HashedKey& hk) const {
+        // Multiply-shift range reduction: uniform for any shard count, no modulo.
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(hash_mix32(hk.hash)) * shards_.size()) >> 32);
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+using ShardedHyperion = BasicShardedHyperion<>;
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "hash.hpp"
+#include "io.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct SnapshotOptions {
+    std::size_t buffer_bytes = 1u << 20; ///< Bytes per block (one write each).
+    std::uint32_t buffers = 4;           ///< Blocks in flight before the snapshot thread waits for the disk.
+    IoBackend io = IoBackend::Auto;      ///< How blocks reach the disk (see AsyncFile).
+};
+
+enum class SnapshotError { None, Busy, OpenFailed, IoFailed, BadFile, Full };
+
+/// \brief Arena extent [begin, end) a snapshot reads.
+struct SnapshotRange {
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+/// \brief First bytes of a snapshot file. Written last, so a file with a valid magic is complete.
+struct SnapshotHeader {
+    static constexpr char MAGIC[8] = {'H', 'Y', 'P', 'S', 'N', 'A', 'P', '1'};
+
+    char magic[8];
+    std::uint64_t format;      // Hash probe of the writing engine: identifies the HashT of the stored hashes.
+    std::uint64_t entries;
+    std::uint64_t bytes;       // Bytes of blocks after HEADER_BYTES.
+    std::uint64_t block_bytes; // Largest block, frame included.
+};
+
+/// \brief Background writer of one point-in-time snapshot file.
+///
+/// \details
+/// start() records the Arena ranges written so far and spawns a thread that runs the engine's
+/// walk over them; the walk passes each entry that was live at start() to append(). The writer
+/// thread keeps running meanwhile. It only has to leave the bytes inside the ranges untouched and
+/// call retire() on an entry inside them before the last index slot pointing at it changes, so
+/// the walk can still tell the entry was live: an entry was live at start() iff a slot points at
+/// it now or it was retired since. Retirements are one bit per 8-byte Arena unit, set with an
+/// atomic OR (the bitmap's zero pages come from the OS lazily).
+///
+/// Entries are packed into blocks of up to SnapshotOptions::buffer_bytes, each framed as
+/// `crc32c | length` (Crc32cHash), and written through an AsyncFile, so the walk only waits when
+/// every buffer is still on its way to disk: throughput is bounded by the device, not the writer.
+/// The file is built as `path.tmp`, synced, stamped with its header, synced again and renamed
+/// over `path`, so a crash never leaves a partial snapshot where a complete one was.
+class Snapshot {
+public:
+    /// Bytes reserved for the header in front of the first block.
+    static constexpr std::size_t HEADER_BYTES = 64;
+    /// Bytes of a block's frame (checksum and payload length).
+    static constexpr std::size_t FRAME = 8;
+
+    /// \brief Creates `path.tmp` and starts body(Snapshot&) on the snapshot thread.
+    /// \param format Hash probe of the engine (see SnapshotHeader::format).
+    /// \param ranges Arena extents the walk reads (at most two).
+    /// \return nullptr with err set if the file or the I/O backend cannot be opened.
+    template <typename Fn>
+    static std::unique_ptr<Snapshot> start(const char* path, std::uint64_t format, std::span<const SnapshotRange> ranges,
+                                           const SnapshotOptions& opts, SnapshotError& err, Fn&& body) {
+        err = SnapshotError::None;
+        std::unique_ptr<Snapshot> s(new Snapshot(path, format, opts));
+        if (!s->file_.open(s->tmp_.c_str(), true)) { err = SnapshotError::OpenFailed; return nullptr; }
+        // Each buffer needs a write in flight; the finishing sync and header take two more.
+        if (!s->io_.start(s->file_, opts.io, static_cast<std::uint32_t>(s->bufs_.size()) + 2)) {
+            err = SnapshotError::OpenFailed;
+            std::remove(s->tmp_.c_str());
+            return nullptr;
+        }
+
+        const std::size_t n = std::min<std::size_t>(ranges.size(), 2);
+        for (std::size_t i = 0; i < n; ++i) s->ranges_[s->count_++] = ranges[i];
+        if (n != 0) {
+            s->lo_ = ranges[0].begin;
+            std::uint64_t hi = ranges[0].end;
+            for (std::size_t i = 1; i < n; ++i) {
+                s->lo_ = std::min(s->lo_, ranges[i].begin);
+                hi = std::max(hi, ranges[i].end);
+            }
+            s->retired_ = static_cast<std::uint64_t*>(std::calloc(((hi - s->lo_) >> 9) + 1, sizeof(std::uint64_t)));
+            if (s->retired_ == nullptr) {
+                err = SnapshotError::OpenFailed;
+                s->io_.stop();
+                s->file_.close();
+                std::remove(s->tmp_.c_str());
+                return nullptr;
+            }
+        }
+
+        s->thread_ = std::thread([p = s.get(), fn = std::forward<Fn>(body)]() mutable {
+            fn(*p);
+            p->finish();
+        });
+        return s;
+    }
+
+    /// \brief Waits for the snapshot thread; the file is complete (or removed) afterwards.
+    ~Snapshot() {
+        wait();
+        io_.stop();
+        std::free(retired_);
+    }
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /// \brief Ranges captured at start().
+    std::span<const SnapshotRange> ranges() const { return {ranges_, count_}; }
+
+    /// \brief True if the Arena offset lies in a captured range.
+    bool covers(std::uint64_t offset) const {
+        for (std::uint32_t i = 0; i < count_; ++i) {
+            if (offset >= ranges_[i].begin && offset < ranges_[i].end) return true;
+        }
+        return false;
+    }
+
+    /// \brief Marks a covered entry as live at start() (writer thread, before its slot changes).
+    void retire(std::uint64_t offset) {
+        const std::uint64_t unit = (offset - lo_) >> 3;
+        std::atomic_ref<std::uint64_t>(retired_[unit >> 6]).fetch_or(std::uint64_t(1) << (unit & 63), std::memory_order_release);
+    }
+
+    /// \brief True if retire() was called for the entry at offset (snapshot thread).
+    bool retired(std::uint64_t offset) const {
+        const std::uint64_t unit = (offset - lo_) >> 3;
+        return (std::atomic_ref<std::uint64_t>(retired_[unit >> 6]).load(std::memory_order_acquire) >> (unit & 63)) & 1;
+    }
+
+    /// \brief Adds one entry's bytes to the file (snapshot thread).
+    /// \return false once a write has failed; the walk should stop.
+    bool append(const void* data, std::size_t n) {
+        if (failed_) return false;
+        if (fill_ + n > block_bytes_) submit_block();
+        std::memcpy(bufs_[cur_].data() + fill_, data, n);
+        fill_ += n;
+        ++entries_;
+        return !failed_;
+    }
+
+    /// \brief True once the file is complete (or has failed). Never blocks.
+    bool done() const { return done_.load(std::memory_order_acquire); }
+
+    /// \brief Waits for the snapshot thread and returns the outcome.
+    SnapshotError wait() {
+        if (thread_.joinable()) thread_.join();
+        return result_;
+    }
+
+    /// \brief Reads a snapshot file, invoking fn(std::string_view block) per verified block.
+    /// \details Blocks hold whole entries in Arena format. `hdr` is filled before the first
+    /// call. fn returns SnapshotError::None to continue; anything else stops the load and is
+    /// returned. BadFile if the file is incomplete or a block fails its checksum; blocks before
+    /// a corrupt one have already been passed to fn.
+    template <typename Fn>
+    static SnapshotError load(const char* path, SnapshotHeader& hdr, Fn&& fn) {
+        File f;
+        if (!f.open_read(path)) return SnapshotError::OpenFailed;
+        const std::uint64_t size = f.size();
+        if (size < HEADER_BYTES || !f.read_at(0, &hdr, sizeof(hdr))) return SnapshotError::BadFile;
+        if (std::memcmp(hdr.magic, SnapshotHeader::MAGIC, sizeof(hdr.magic)) != 0 || hdr.bytes != size - HEADER_BYTES ||
+            hdr.block_bytes < FRAME || hdr.block_bytes > MAX_BLOCK) {
+            return SnapshotError::BadFile;
+        }
+
+        std::vector<char> buf(static_cast<std::size_t>(hdr.block_bytes));
+        for (std::uint64_t pos = HEADER_BYTES; pos < size;) {
+            std::uint32_t frame[2];
+            if (size - pos < FRAME || !f.read_at(pos, frame, FRAME)) return SnapshotError::BadFile;
+            const std::uint32_t len = frame[1];
+            if (len > hdr.block_bytes - FRAME || len > size - pos - FRAME) return SnapshotError::BadFile;
+            if (!f.read_at(pos + FRAME, buf.data(), len)) return SnapshotError::IoFailed;
+            if (checksum(buf.data(), len) != frame[0]) return SnapshotError::BadFile;
+            SnapshotError err = fn(std::string_view(buf.data(), len));
+            if (err != SnapshotError::None) return err;
+            pos += FRAME + len;
+        }
+        return SnapshotError::None;
+    }
+
+private:
+    static constexpr std::size_t MIN_BLOCK = 128u << 10; // Room for the largest entry.
+    static constexpr std::size_t MAX_BLOCK = 1u << 30;
+
+    static std::uint32_t checksum(const char* p, std::size_t n) {
+        return Crc32cHash::hash(reinterpret_cast<const std::uint8_t*>(p), n);
+    }
+
+    Snapshot(const char* path, std::uint64_t format, const SnapshotOptions& opts)
+        : path_(path), tmp_(std::string(path) + ".tmp"), format_(format),
+          block_bytes_(std::clamp(opts.buffer_bytes, MIN_BLOCK, MAX_BLOCK)),
+          bufs_(std::max(opts.buffers, 1u)), pending_(bufs_.size(), 0) {
+        for (auto& b : bufs_) b.resize(block_bytes_);
+    }
+
+    // Completion tags: a block carries its buffer index; the header and syncs follow them.
+    std::uint64_t header_tag() const { return bufs_.size(); }
+    std::uint64_t sync_tag() const { return bufs_.size() + 1; }
+
+    /// \brief Completion handler for io_: frees written blocks, records failures.
+    struct Completion {
+        Snapshot* s;
+        void operator()(std::uint64_t tag, std::int64_t res) const {
+            std::int64_t want = 0;
+            if (tag < s->bufs_.size()) {
+                want = static_cast<std::int64_t>(s->pending_[tag]);
+                s->pending_[tag] = 0;
+            } else if (tag == s->header_tag()) {
+                want = sizeof(SnapshotHeader);
+            }
+            if (res != want) s->failed_ = true;
+        }
+    };
+
+    /// \brief Frames the current block, submits its write and moves to the next buffer.
+    void submit_block() {
+        if (fill_ == FRAME) return;
+        std::vector<char>& b = bufs_[cur_];
+        const std::uint32_t frame[2] = {checksum(b.data() + FRAME, fill_ - FRAME), static_cast<std::uint32_t>(fill_ - FRAME)};
+        std::memcpy(b.data(), frame, FRAME);
+        pending_[cur_] = fill_;
+        largest_ = std::max<std::uint64_t>(largest_, fill_);
+        const IoRequest req{IoRequest::Op::Write, b.data(), fill_, end_, cur_};
+        if (!io_.submit(&req, 1)) {
+            failed_ = true;
+            pending_[cur_] = 0; // Never queued: no completion will release the buffer.
+        }
+        end_ += fill_;
+
+        cur_ = (cur_ + 1) % bufs_.size();
+        fill_ = FRAME;
+        // Backpressure: the next buffer is still being written.
+        while (pending_[cur_] != 0) io_.wait(Completion{this});
+        io_.reap(Completion{this});
+    }
+
+    /// \brief Writes the last block, syncs, stamps the header, syncs and renames (snapshot thread).
+    void finish() {
+        submit_block();
+        SnapshotHeader hdr{};
+        std::memcpy(hdr.magic, SnapshotHeader::MAGIC, sizeof(hdr.magic));
+        hdr.format = format_;
+        hdr.entries = entries_;
+        hdr.bytes = end_ - HEADER_BYTES;
+        hdr.block_bytes = std::max<std::uint64_t>(largest_, FRAME);
+
+        // The header only reaches the disk after every block is stable.
+        const IoRequest reqs[3] = {
+            {IoRequest::Op::Sync, nullptr, 0, 0, sync_tag()},
+            {IoRequest::Op::Write, &hdr, sizeof(hdr), 0, header_tag()},
+            {IoRequest::Op::Sync, nullptr, 0, 0, sync_tag()},
+        };
+        if (!failed_) {
+            while (io_.capacity() < 3) io_.wait(Completion{this});
+            if (!io_.submit(reqs, 3)) failed_ = true;
+        }
+        while (io_.in_flight() != 0) io_.wait(Completion{this});
+        file_.close();
+
+        if (!failed_ && !replace_file(tmp_.c_str(), path_.c_str())) failed_ = true;
+        if (failed_) std::remove(tmp_.c_str());
+        result_ = failed_ ? SnapshotError::IoFailed : SnapshotError::None;
+        done_.store(true, std::memory_order_release);
+    }
+
+    const std::string path_;
+    const std::string tmp_;
+    const std::uint64_t format_;
+    const std::size_t block_bytes_;
+    File file_;
+    AsyncFile io_;
+
+    SnapshotRange ranges_[2] = {};
+    std::uint32_t count_ = 0;
+    std::uint64_t lo_ = 0;                 // Arena offset of the first retired_ bit.
+    std::uint64_t* retired_ = nullptr;     // One bit per 8-byte unit, shared with the writer.
+
+    // Snapshot thread only.
+    std::vector<std::vector<char>> bufs_;  // Ring of block buffers, in flight until reaped.
+    std::vector<std::size_t> pending_;     // Bytes in flight per buffer (0 = free).
+    std::size_t cur_ = 0;
+    std::size_t fill_ = FRAME;             // Bytes used in bufs_[cur_], frame included.
+    std::uint64_t end_ = HEADER_BYTES;     // File offset of the next block.
+    std::uint64_t entries_ = 0;
+    std::uint64_t largest_ = 0;
+    bool failed_ = false;
+    SnapshotError result_ = SnapshotError::None;
+
+    std::atomic<bool> done_{false};
+    std::thread thread_;
+};
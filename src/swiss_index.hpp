@@ -0,0 +1,274 @@
+#pragma once
+
+#include "index.hpp"
+#include <bit>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HYPERION_CTRL_SSE2 1
+#endif
+
+/// \brief Vectorized view over one group of control bytes.
+///
+/// \details
+/// Control byte encoding (Swiss Table):
+///   0x00-0x7F : Full, holds the top 7 bits of the hash.
+///   0x80      : Empty (probe terminator).
+///   0xFE      : Deleted (tombstone, probe continues).
+/// Empty and Deleted both have the sign bit set, so "free" detection is a single movemask.
+struct CtrlGroup {
+    static constexpr std::int8_t EMPTY = -128;
+    static constexpr std::int8_t DELETED = -2;
+
+#if defined(__AVX2__)
+    static constexpr std::uint32_t WIDTH = 32;
+
+    explicit CtrlGroup(const std::int8_t* p) : v_(_mm256_load_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+    std::uint32_t match(std::int8_t h2) const {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v_, _mm256_set1_epi8(h2))));
+    }
+    std::uint32_t match_free() const { return static_cast<std::uint32_t>(_mm256_movemask_epi8(v_)); }
+
+private:
+    __m256i v_;
+#elif defined(HYPERION_CTRL_SSE2)
+    static constexpr std::uint32_t WIDTH = 16;
+
+    explicit CtrlGroup(const std::int8_t* p) : v_(_mm_load_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    std::uint32_t match(std::int8_t h2) const {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v_, _mm_set1_epi8(h2))));
+    }
+    std::uint32_t match_free() const { return static_cast<std::uint32_t>(_mm_movemask_epi8(v_)); }
+
+private:
+    __m128i v_;
+#else
+    // Portable fallback: identical semantics, scalar loop (auto-vectorizes on most targets).
+    static constexpr std::uint32_t WIDTH = 16;
+
+    explicit CtrlGroup(const std::int8_t* p) { std::memcpy(b_, p, WIDTH); }
+
+    std::uint32_t match(std::int8_t h2) const {
+        std::uint32_t m = 0;
+        for (std::uint32_t i = 0; i < WIDTH; ++i) m |= static_cast<std::uint32_t>(b_[i] == h2) << i;
+        return m;
+    }
+    std::uint32_t match_free() const {
+        std::uint32_t m = 0;
+        for (std::uint32_t i = 0; i < WIDTH; ++i) m |= static_cast<std::uint32_t>(b_[i] < 0) << i;
+        return m;
+    }
+
+private:
+    std::int8_t b_[WIDTH];
+#endif
+
+public:
+    std::uint32_t match_empty() const { return match(EMPTY); }
+};
+
+/// \brief Open-Addressing Hash Index with Swiss Table style group probing.
+///
+/// \details
+/// Slot metadata (7-bit hash fragment + state) lives in a dense control array separate from
+/// the Slots. A lookup loads one aligned group of control bytes and resolves all candidates
+/// with a single compare, touching the Slot array only for tag hits. Probing advances one
+/// group at a time and stops at the first group containing an Empty byte.
+///
+/// Drop-in replacement for Index: exposes the same find/update/insert/erase/at contract.
+/// \tparam SlotT Slot layout: Slot (16-byte) or CompactSlot (8-byte).
+template <typename SlotT = Slot>
+class BasicSwissIndex {
+public:
+    using slot_type = SlotT;
+
+    static constexpr std::uint32_t GROUP = CtrlGroup::WIDTH;
+    /// Position returned by find() when no insertion candidate exists (table full).
+    static constexpr std::uint32_t NPOS = UINT32_MAX;
+
+    BasicSwissIndex() = default;
+
+    // Move-only resource management
+    BasicSwissIndex(BasicSwissIndex&&) = default;
+    BasicSwissIndex& operator=(BasicSwissIndex&&) = default;
+    BasicSwissIndex(const BasicSwissIndex&) = delete;
+    BasicSwissIndex& operator=(const BasicSwissIndex&) = delete;
+
+    /// \brief Page placement for the slot and side arrays (call before init()).
+    void set_memory(const MemoryOptions& mem) { mem_ = mem; }
+
+    /// \brief Page size backing the slot array.
+    PageMode page_mode() const { return slots_.mode(); }
+
+    /// \brief True if the slot and side arrays are pinned in RAM.
+    bool locked() const { return slots_.locked() && ctrl_.locked(); }
+
+    /// \brief NUMA node both arrays are bound to, -1 if unbound.
+    std::int32_t numa_node() const { return slots_.numa_node() == ctrl_.numa_node() ? slots_.numa_node() : -1; }
+
+    void init(std::uint32_t slots) {
+        // Capacity is a whole number of groups so every group load is aligned and in-bounds.
+        capacity_ = std::bit_ceil(std::max(slots, GROUP));
+        mask_ = capacity_ - 1;
+        group_mask_ = capacity_ / GROUP - 1;
+        slots_ = PageArray<SlotT>(capacity_, mem_);
+        ctrl_ = PageArray<CtrlBlock>(capacity_ / GROUP, mem_);
+        for(std::uint32_t i=0; i<capacity_; ++i) slots_[i] = SlotT::empty();
+        std::memset(ctrl_.get(), static_cast<std::uint8_t>(CtrlGroup::EMPTY), capacity_);
+    }
+
+    /// Identifies the init_shared() layout to processes attaching to it. The group width (32 with
+    /// AVX2, 16 otherwise) decides which control bytes a probe reads, so builds that disagree on
+    /// it must not share a table.
+    static constexpr std::uint32_t SHARED_KIND = 2 | (GROUP << 8);
+
+    /// \brief Bytes init_shared() places for `slots`: the control bytes, then the slots.
+    static std::size_t shared_bytes(std::uint32_t slots) {
+        return std::size_t(std::bit_ceil(std::max(slots, GROUP))) * (1 + sizeof(SlotT));
+    }
+
+    /// \brief init() over shared_bytes(slots) of caller memory (64-byte aligned), e.g. a shared-memory region.
+    /// \details `fresh` empties the table; otherwise it is adopted as found, by a process attaching
+    /// to a table another one writes.
+    void init_shared(std::uint32_t slots, void* mem, bool fresh) {
+        capacity_ = std::bit_ceil(std::max(slots, GROUP));
+        mask_ = capacity_ - 1;
+        group_mask_ = capacity_ / GROUP - 1;
+        auto* bytes = static_cast<std::uint8_t*>(mem);
+        ctrl_ = PageArray<CtrlBlock>::borrow(reinterpret_cast<CtrlBlock*>(bytes));
+        slots_ = PageArray<SlotT>::borrow(reinterpret_cast<SlotT*>(bytes + capacity_));
+        if (fresh) {
+            for(std::uint32_t i=0; i<capacity_; ++i) slots_[i] = SlotT::empty();
+            std::memset(ctrl_.get(), static_cast<std::uint8_t>(CtrlGroup::EMPTY), capacity_);
+        }
+    }
+
+    /// \brief Group Probe Lookup.
+    /// \param eq Functor for deep key comparison.
+    /// \return Pair {Index, Found}. If !Found, Index is the insertion candidate (or NPOS if full).
+    template <typename KeyEq>
+    std::pair<std::uint32_t, bool> find(std::uint32_t h, std::size_t klen, KeyEq&& eq) const {
+        const std::int8_t h2 = ctrl_tag(h);
+        std::uint32_t g = (h & mask_) / GROUP;
+        std::uint32_t first_free = NPOS;
+
+        for(std::uint32_t i=0; i<=group_mask_; ++i) {
+            CtrlGroup grp(ctrl_[g].bytes);
+            const std::uint32_t base = g * GROUP;
+
+            // All tag hits in this group, resolved from one vector compare.
+            for(std::uint32_t m = grp.match(h2); m != 0; m &= m - 1) {
+                const std::uint32_t idx = base + static_cast<std::uint32_t>(std::countr_zero(m));
+                const SlotT& s = slots_[idx];
+                if (s.key_len == klen && eq(s)) return {idx, true};
+            }
+
+            if (first_free == NPOS) {
+                // Remember the first Empty/Deleted byte as the insertion candidate.
+                std::uint32_t f = grp.match_free();
+                if (f != 0) first_free = base + static_cast<std::uint32_t>(std::countr_zero(f));
+            }
+
+            // An Empty byte proves the key was never displaced past this group.
+            if (grp.match_empty() != 0) return {first_free, false};
+
+            g = (g + 1) & group_mask_;
+        }
+        // Table Full: first_free is NPOS unless a Deleted byte can be recycled.
+        return {first_free, false};
+    }
+
+    void update(std::uint32_t idx, std::uint8_t tag, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        slots_[idx] = SlotT::make(tag, klen, vlen, ref);
+        // The Slot tag is (h >> 24); the control byte keeps its top 7 bits.
+        ctrl_[idx / GROUP].bytes[idx % GROUP] = static_cast<std::int8_t>(tag >> 1);
+    }
+
+    /// \brief Inserts a new entry at the candidate returned by an unsuccessful find.
+    /// \return false if the table is full (idx == NPOS).
+    bool insert(std::uint32_t idx, std::uint32_t h, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        if (idx == NPOS) return false;
+        update(idx, static_cast<std::uint8_t>(h >> 24), klen, vlen, ref);
+        return true;
+    }
+
+    /// \brief Removes the entry at idx.
+    /// \details If the group still holds an Empty byte, no probe ever continued past it,
+    /// so the slot can revert to Empty instead of leaving a tombstone.
+    void erase(std::uint32_t idx) {
+        slots_[idx].make_tombstone();
+        CtrlBlock& blk = ctrl_[idx / GROUP];
+        blk.bytes[idx % GROUP] = (CtrlGroup(blk.bytes).match_empty() != 0) ? CtrlGroup::EMPTY : CtrlGroup::DELETED;
+    }
+
+    /// \brief find() confined to the groups below slot hi, for parallel builds over disjoint,
+    /// group-aligned ranges.
+    /// \details The candidate is the first Empty byte of the group that ends the probe.
+    /// \return {idx, found} as find(), or {NPOS, false} if the probe leaves the range.
+    template <typename KeyEq>
+    std::pair<std::uint32_t, bool> find_in(std::uint32_t hi, std::uint32_t h, std::size_t klen, KeyEq&& eq) const {
+        const std::int8_t h2 = ctrl_tag(h);
+        for(std::uint32_t g = (h & mask_) / GROUP; g * GROUP < hi; ++g) {
+            CtrlGroup grp(ctrl_[g].bytes);
+            const std::uint32_t base = g * GROUP;
+            for(std::uint32_t m = grp.match(h2); m != 0; m &= m - 1) {
+                const std::uint32_t idx = base + static_cast<std::uint32_t>(std::countr_zero(m));
+                if (slots_[idx].key_len == klen && eq(slots_[idx])) return {idx, true};
+            }
+            const std::uint32_t e = grp.match_empty();
+            if (e != 0) return {base + static_cast<std::uint32_t>(std::countr_zero(e)), false};
+        }
+        return {NPOS, false};
+    }
+
+    /// \brief Stores a new entry at a candidate from find_in(). Touches only its slot and control byte.
+    void insert_in(std::uint32_t idx, std::uint32_t h, std::uint8_t klen, std::uint16_t vlen, std::uint64_t ref) {
+        insert(idx, h, klen, vlen, ref);
+    }
+
+    /// \brief Nothing to account: occupancy lives in the control bytes.
+    void bulk_done(std::uint32_t) {}
+
+    /// \brief Fixed capacity: nothing to migrate.
+    template <typename HashOf>
+    void migrate(HashOf&&) {}
+
+    /// \brief Every write stores a single Slot and control byte, so it never disturbs other keys.
+    bool local_writes() const { return true; }
+
+    /// \brief Prefetches the home control group and its first Slots.
+    void prefetch(std::uint32_t h) const {
+        std::uint32_t g = (h & mask_) / GROUP;
+        prefetch_line(ctrl_[g].bytes);
+        prefetch_line(&slots_[g * GROUP]);
+    }
+
+    SlotT& at(std::uint32_t idx) { return slots_[idx]; }
+    const SlotT& at(std::uint32_t idx) const { return slots_[idx]; }
+    std::uint32_t cap() const { return capacity_; }
+    std::uint32_t mask() const { return mask_; }
+
+private:
+    struct alignas(GROUP) CtrlBlock {
+        std::int8_t bytes[GROUP];
+    };
+
+    static std::int8_t ctrl_tag(std::uint32_t h) { return static_cast<std::int8_t>(h >> 25); }
+
+    PageArray<SlotT> slots_;
+    PageArray<CtrlBlock> ctrl_;
+    MemoryOptions mem_;
+    std::uint32_t capacity_ = 0;
+    std::uint32_t mask_ = 0;
+    std::uint32_t group_mask_ = 0;
+};
+
+using SwissIndex = BasicSwissIndex<>;
+
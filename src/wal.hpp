@@ -0,0 +1,404 @@
+#pragma once
+
+#include "hash.hpp"
+#include "io.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// \brief When the log forces appended records to stable storage.
+enum class WalSync : std::uint8_t {
+    None,     ///< Write groups to the OS; fsync only on WriteAheadLog::sync(). Survives process crashes.
+    Interval, ///< Write and fsync whatever accumulated every WalOptions::interval_ms.
+    Records,  ///< Write and fsync once WalOptions::records records have accumulated.
+};
+
+struct WalOptions {
+    WalSync sync = WalSync::Interval;
+    std::uint32_t interval_ms = 5;        ///< Group window for WalSync::Interval.
+    std::uint32_t records = 256;          ///< Group size for WalSync::Records.
+    std::size_t buffer_bytes = 1u << 20;  ///< A group is also committed once its buffer reaches this size.
+    std::uint32_t groups = 8;             ///< Committed groups that may be in flight before the writer waits.
+    IoBackend io = IoBackend::Auto;       ///< How groups reach the disk (see AsyncFile).
+};
+
+/// \brief Outcome of a log operation. ApplyFailed: a replayed record did not fit the engine
+/// (BasicHyperion::recover()).
+enum class WalError { None, OpenFailed, BadFile, IoFailed, ApplyFailed };
+
+enum class WalOp : std::uint8_t { Put = 1, Del = 2 };
+
+/// \brief Append-only write-ahead log with group commit.
+///
+/// \details
+/// The writer thread appends records to an in-memory group buffer and never waits for I/O: it
+/// takes the buffer's mutex only with try_lock, and while the committer holds it (to swap the
+/// buffer out) records go to a spill buffer under a second, short-held lock. Whoever next holds
+/// the group mutex, the writer or the committer, folds the spill buffer into the group, so an
+/// idle writer's last records still go out on the committer's schedule.
+/// A group is committed when the sync policy says so or the buffer fills: the writer only
+/// wakes the committer thread, which swaps the buffer into one of WalOptions::groups ring
+/// buffers and submits its write (and, per WalSync, a datasync barrier) through an
+/// AsyncFile, io_uring where available. All I/O submission and every wait for completions run
+/// on the committer, never under the mutex. If every ring buffer is still on its way to disk,
+/// the writer keeps filling its buffer instead of blocking. fsync cost is amortized over every
+/// record in a group and never paid per put.
+///
+/// The committer also commits WalSync::Interval groups on its timer and reaps completions
+/// while the writer is idle.
+///
+/// Record layout: `crc32c | op | klen | vlen | key | value`, where the checksum (Crc32cHash) covers
+/// everything after itself. A crash can only tear the tail; replay() stops at the first record
+/// that does not verify and truncates the file there.
+///
+/// appended() and durable() count records, so a caller that must know a write is on disk can
+/// compare its position against durable() or call sync().
+class WriteAheadLog {
+public:
+    /// \brief Opens (or creates) the log at `path` and starts its I/O backend.
+    /// \details Appends go to the end of the file; call replay() first to recover its records
+    /// and drop a torn tail.
+    /// \return nullptr with err set if the file cannot be opened or is not a log.
+    static std::unique_ptr<WriteAheadLog> open(const char* path, const WalOptions& opts, WalError& err) {
+        err = WalError::None;
+        std::unique_ptr<WriteAheadLog> wal(new WriteAheadLog(opts));
+        if (!wal->file_.open(path)) { err = WalError::OpenFailed; return nullptr; }
+
+        std::uint64_t size = wal->file_.size();
+        if (size == 0) {
+            if (!wal->file_.write_at(0, FILE_MAGIC, sizeof(FILE_MAGIC)) || !wal->file_.sync()) { err = WalError::IoFailed; return nullptr; }
+            size = sizeof(FILE_MAGIC);
+        } else {
+            char magic[sizeof(FILE_MAGIC)] = {};
+            if (size < sizeof(FILE_MAGIC) || !wal->file_.read_at(0, magic, sizeof(magic)) ||
+                std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) {
+                err = WalError::BadFile;
+                return nullptr;
+            }
+        }
+        // Each group needs at most a write and a barrier in flight.
+        if (!wal->io_.start(wal->file_, opts.io, 2 * static_cast<std::uint32_t>(wal->groups_.size()))) {
+            err = WalError::OpenFailed;
+            return nullptr;
+        }
+        wal->end_ = size;
+        wal->timer_ = std::thread([w = wal.get()] { w->run(); });
+        return wal;
+    }
+
+    /// \brief Commits and writes every appended record, fsyncs, then stops the I/O backend.
+    ~WriteAheadLog() {
+        if (timer_.joinable()) {
+            sync();
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                stop_ = true;
+            }
+            tick_.notify_one();
+            timer_.join();
+        }
+        io_.stop();
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /// Bytes in front of the first record.
+    static constexpr std::size_t HEADER_BYTES = 8;
+    /// Bytes of a record before its key.
+    static constexpr std::size_t RECORD_HEADER = 8;
+
+    /// \brief Reads the log from the start, invoking fn(WalOp, key, value) per intact record.
+    /// \details Reads sequentially in large chunks. Stops at the first torn or corrupt record and
+    /// truncates the file there, so later appends follow the last good record. Views passed
+    /// to fn are valid for the duration of the call. Call before the first append().
+    /// \param records Receives the number of records replayed.
+    template <typename Fn>
+    WalError replay(Fn&& fn, std::uint64_t& records) {
+        records = 0;
+        const std::uint64_t size = file_.size();
+        std::vector<char> buf(REPLAY_CHUNK);
+        std::uint64_t pos = HEADER_BYTES; // File offset of buf[0].
+        std::size_t have = 0, at = 0;
+
+        for (;;) {
+            // Keep at least one maximal record in the buffer; slide the remainder down and refill.
+            if (have - at < MAX_RECORD && pos + have < size) {
+                std::memmove(buf.data(), buf.data() + at, have - at);
+                pos += at; have -= at; at = 0;
+                std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(buf.size() - have, size - pos - have));
+                if (!file_.read_at(pos + have, buf.data() + have, want)) return WalError::IoFailed;
+                have += want;
+            }
+
+            const char* p = buf.data() + at;
+            if (have - at < RECORD_HEADER) break;
+            std::uint32_t crc;
+            std::memcpy(&crc, p, 4);
+            const auto op = static_cast<WalOp>(p[4]);
+            const std::size_t klen = static_cast<std::uint8_t>(p[5]);
+            std::uint16_t vlen;
+            std::memcpy(&vlen, p + 6, 2);
+            const std::size_t len = RECORD_HEADER + klen + vlen;
+            if (len > have - at || (op != WalOp::Put && op != WalOp::Del)) break;
+            if (checksum(p + 4, len - 4) != crc) break;
+
+            fn(op, std::string_view(p + RECORD_HEADER, klen), std::string_view(p + RECORD_HEADER + klen, vlen));
+            ++records;
+            at += len;
+        }
+
+        const std::uint64_t end = pos + at;
+        if (end < size && !file_.truncate(end)) return WalError::IoFailed;
+        std::lock_guard<std::mutex> lk(m_);
+        end_ = end;
+        handed_ = records;
+        appended_.store(records, std::memory_order_relaxed);
+        durable_.store(records, std::memory_order_relaxed);
+        return WalError::None;
+    }
+
+    /// \brief Appends a record to the current group (Single Writer). Never waits for I/O.
+    /// \details Wakes the committer when the sync policy or the buffer size calls for a commit.
+    void append(WalOp op, std::string_view key, std::string_view val) {
+        appended_.store(appended_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        bool full = false;
+        if (m_.try_lock()) {
+            std::lock_guard<std::mutex> lk(m_, std::adopt_lock);
+            hand_spill();
+            encode(active_, op, key, val);
+            ++handed_;
+            full = active_.size() >= opts_.buffer_bytes;
+        } else {
+            // The committer is swapping the group out; it folds the spill buffer in before the swap.
+            std::lock_guard<std::mutex> sl(spill_m_);
+            encode(spill_, op, key, val);
+            ++spilled_records_;
+            spilled_.store(true, std::memory_order_release);
+        }
+
+        if (full || (opts_.sync == WalSync::Records && ++grouped_ >= opts_.records)) {
+            grouped_ = 0;
+            kick();
+        }
+    }
+
+    /// \brief Has the current group submitted now (Single Writer). Returns without waiting for the disk.
+    void commit() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            hand_spill();
+        }
+        kick();
+    }
+
+    /// \brief Commits the current group and waits until every record appended so far is on disk.
+    /// \return false if any write or fsync has failed.
+    bool sync() {
+        std::unique_lock<std::mutex> lk(m_);
+        hand_spill();
+        const std::uint64_t target = handed_;
+        sync_wanted_ = true;
+        kick();
+        flushed_.wait(lk, [&] {
+            return (!sync_wanted_ && durable_.load(std::memory_order_acquire) >= target) || failed_.load(std::memory_order_acquire);
+        });
+        return !failed_.load(std::memory_order_acquire);
+    }
+
+    /// \brief Records appended since the log was opened (including replayed ones).
+    std::uint64_t appended() const { return appended_.load(std::memory_order_acquire); }
+
+    /// \brief Records known to be on stable storage (advances as completions are reaped).
+    std::uint64_t durable() const { return durable_.load(std::memory_order_acquire); }
+
+    /// \brief True once a write or fsync has failed; later groups are dropped.
+    bool failed() const { return failed_.load(std::memory_order_acquire); }
+
+    /// \brief I/O backend the log runs on (Auto resolved).
+    IoBackend backend() const { return io_.backend(); }
+
+private:
+    static constexpr char FILE_MAGIC[8] = {'H', 'Y', 'P', 'W', 'A', 'L', '0', '1'};
+    static constexpr std::size_t MAX_RECORD = RECORD_HEADER + 255 + 65535;
+    static constexpr std::size_t REPLAY_CHUNK = 8u << 20;
+
+    static std::uint32_t checksum(const char* p, std::size_t n) {
+        return Crc32cHash::hash(reinterpret_cast<const std::uint8_t*>(p), n);
+    }
+
+    /// \brief A committed group's bytes, pinned until its write completes.
+    struct Group {
+        std::vector<char> buf;
+        bool busy = false;
+    };
+
+    // Completion tags: a write carries its group index, a barrier the record count it covers.
+    static std::uint64_t write_tag(std::size_t group) { return static_cast<std::uint64_t>(group) << 1; }
+    static std::uint64_t sync_tag(std::uint64_t lsn) { return (lsn << 1) | 1; }
+
+    explicit WriteAheadLog(const WalOptions& opts) : opts_(opts), groups_(std::max(opts.groups, 1u)) {
+        active_.reserve(opts_.buffer_bytes);
+        for (Group& g : groups_) g.buf.reserve(opts_.buffer_bytes);
+    }
+
+    /// \brief Completion handler for io_: frees written groups, advances durable() on barriers.
+    struct Completion {
+        WriteAheadLog* wal;
+        void operator()(std::uint64_t tag, std::int64_t res) const {
+            if ((tag & 1) == 0) {
+                Group& g = wal->groups_[tag >> 1];
+                if (res != static_cast<std::int64_t>(g.buf.size())) wal->failed_.store(true, std::memory_order_release);
+                g.buf.clear();
+                g.busy = false;
+            } else if (res < 0) {
+                wal->failed_.store(true, std::memory_order_release);
+            } else if (!wal->failed_.load(std::memory_order_relaxed)) {
+                const std::uint64_t lsn = std::max(wal->durable_.load(std::memory_order_relaxed), tag >> 1);
+                wal->durable_.store(lsn, std::memory_order_release);
+            }
+        }
+    };
+
+    /// \brief Serializes a record onto the end of `buf`.
+    static void encode(std::vector<char>& buf, WalOp op, std::string_view key, std::string_view val) {
+        const std::size_t len = RECORD_HEADER + key.size() + val.size();
+        const std::size_t at = buf.size();
+        buf.resize(at + len);
+        char* p = buf.data() + at;
+        p[4] = static_cast<char>(op);
+        p[5] = static_cast<char>(key.size());
+        const std::uint16_t vlen = static_cast<std::uint16_t>(val.size());
+        std::memcpy(p + 6, &vlen, 2);
+        std::memcpy(p + RECORD_HEADER, key.data(), key.size());
+        std::memcpy(p + RECORD_HEADER + key.size(), val.data(), val.size());
+        const std::uint32_t crc = checksum(p + 4, len - 4);
+        std::memcpy(p, &crc, 4);
+    }
+
+    /// \brief Moves records spilled while m_ was taken into the active group. Holds m_.
+    void hand_spill() {
+        if (!spilled_.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> sl(spill_m_);
+        active_.insert(active_.end(), spill_.begin(), spill_.end());
+        spill_.clear();
+        handed_ += spilled_records_;
+        spilled_records_ = 0;
+        spilled_.store(false, std::memory_order_relaxed);
+    }
+
+    /// \brief Wakes the committer. A wakeup racing its wait is picked up by the next timer tick.
+    void kick() {
+        kicked_.store(true, std::memory_order_release);
+        tick_.notify_one();
+    }
+
+    /// \brief Submits the active group (and a barrier, per policy) at the end of the file.
+    /// \details Committer thread only; m_ is taken just to swap the group out, never across I/O.
+    /// \param force_sync Submit a barrier even for an empty group or under WalSync::None.
+    void commit(bool force_sync) {
+        // Backpressure lands here: the writer keeps appending while the next buffer drains.
+        while (groups_[next_].busy) io_.wait(Completion{this});
+        Group& g = groups_[next_];
+        std::uint64_t lsn;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            hand_spill();
+            g.buf.swap(active_);
+            lsn = handed_;
+        }
+        const bool write = !g.buf.empty();
+        const bool barrier = force_sync || (write && opts_.sync != WalSync::None);
+        if (failed_.load(std::memory_order_relaxed)) { g.buf.clear(); return; }
+        if (!write && !barrier) return;
+
+        IoRequest reqs[2];
+        std::uint32_t n = 0;
+        if (write) {
+            g.busy = true;
+            reqs[n++] = {IoRequest::Op::Write, g.buf.data(), g.buf.size(), end_, write_tag(next_)};
+            end_ += g.buf.size();
+            next_ = (next_ + 1) % groups_.size();
+        }
+        if (barrier) reqs[n++] = {IoRequest::Op::Sync, nullptr, 0, 0, sync_tag(lsn)};
+
+        while (io_.capacity() < n) io_.wait(Completion{this});
+        if (!io_.submit(reqs, n)) {
+            // The log is failed from here on. Let whatever the backend did accept complete, then
+            // release groups whose write never went out, so later commits do not wait on them.
+            failed_.store(true, std::memory_order_release);
+            while (io_.in_flight() != 0) io_.wait(Completion{this});
+            for (Group& grp : groups_) {
+                grp.buf.clear();
+                grp.busy = false;
+            }
+        }
+    }
+
+    /// \brief Committer thread: commits groups when kicked or (WalSync::Interval) on its timer,
+    /// completes sync() requests, and reaps completions while the writer is idle.
+    void run() {
+        std::unique_lock<std::mutex> lk(m_);
+        while (!stop_) {
+            tick_.wait_for(lk, std::chrono::milliseconds(std::max(opts_.interval_ms, 1u)),
+                           [&] { return stop_ || kicked_.load(std::memory_order_acquire); });
+            if (stop_) return;
+            const bool kicked = kicked_.exchange(false, std::memory_order_acq_rel);
+            const bool force = sync_wanted_;
+            const bool write = kicked || (opts_.sync == WalSync::Interval && (!active_.empty() || spilled_.load(std::memory_order_acquire)));
+            lk.unlock();
+
+            io_.reap(Completion{this});
+            if (write || force) commit(force);
+            if (force) {
+                while (io_.in_flight() != 0) io_.wait(Completion{this});
+            }
+
+            lk.lock();
+            if (force) {
+                sync_wanted_ = false;
+                flushed_.notify_all();
+            }
+        }
+    }
+
+    const WalOptions opts_;
+    File file_;
+    AsyncFile io_;
+
+    std::mutex m_;                  // Guards active_, handed_, sync_wanted_ and stop_; never held across I/O.
+    std::condition_variable tick_;  // Wakes the committer.
+    std::condition_variable flushed_; // Wakes sync() once its barrier completed.
+    std::vector<char> active_;      // Group being appended to.
+    std::uint64_t handed_ = 0;      // Records in active_ or committed (excludes spill_).
+    bool sync_wanted_ = false;
+    bool stop_ = false;
+
+    std::mutex spill_m_;            // Guards spill_ and spilled_records_; held only to copy records.
+    std::vector<char> spill_;       // Records appended while m_ was taken.
+    std::uint64_t spilled_records_ = 0;
+    std::atomic<bool> spilled_{false}; // spill_ is non-empty (set by the writer, cleared under m_).
+
+    // Writer thread only.
+    std::uint32_t grouped_ = 0;     // Records since the last kick (WalSync::Records).
+
+    // Committer thread only (and the completions it reaps).
+    std::vector<Group> groups_;     // Ring of committed groups, in flight until reaped.
+    std::size_t next_ = 0;
+    std::uint64_t end_ = 0;         // File offset of the next group.
+
+    std::atomic<bool> kicked_{false};
+    std::atomic<std::uint64_t> appended_{0};
+    std::atomic<std::uint64_t> durable_{0};
+    std::atomic<bool> failed_{false};
+    std::thread timer_;
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "hyperion.hpp"
+#include <atomic>
+#include <bit>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/// \brief Multi-producer write front end owning the engine's single writer thread.
+///
+/// \details
+/// Producers enqueue put/del commands into a bounded lock-free MPSC ring (per-cell sequence
+/// numbers; a producer claims a cell with one CAS on the tail). The owned writer thread drains
+/// up to DRAIN_BATCH ready commands at a time and applies each run of consecutive puts with one
+/// write_batch call, so the SeqLock is bumped once per run instead of once per key.
+///
+/// Commands are applied in enqueue order. Producers either fire-and-forget (post_put/post_del)
+/// or receive a std::future<Status> completed once the command is applied (put/del). Key and
+/// value bytes are copied into the cell, whose buffer is reused, so callers' memory may be
+/// released immediately.
+///
+/// Readers keep using the engine directly and stay lock-free. While the queue lives it is the
+/// engine's only writer: no other thread may call a write method on it.
+/// \tparam DB A BasicHyperion instantiation.
+template <typename DB = Hyperion>
+class BasicWriteQueue {
+public:
+    /// Maximum commands applied per drain pass.
+    static constexpr std::uint32_t DRAIN_BATCH = 256;
+
+    /// \brief Starts the writer thread over `db`.
+    /// \param capacity Ring size in commands (rounded up to a power of two).
+    explicit BasicWriteQueue(DB& db, std::uint32_t capacity = 4096)
+        : db_(db), capacity_(std::bit_ceil(std::max(capacity, 2u))), mask_(capacity_ - 1),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for(std::uint32_t i=0; i<capacity_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+        batch_.reserve(DRAIN_BATCH);
+        writer_ = std::thread([this] { run(); });
+    }
+
+    /// \brief Applies every command already enqueued, then joins the writer thread.
+    ~BasicWriteQueue() {
+        stop_.store(true, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake();
+        writer_.join();
+    }
+
+    BasicWriteQueue(const BasicWriteQueue&) = delete;
+    BasicWriteQueue& operator=(const BasicWriteQueue&) = delete;
+
+    /// \brief Fire-and-forget Put (Multi-Producer).
+    /// \return KeyTooLong/ValTooLong immediately, else OK once the command is queued.
+    Status post_put(std::string_view key, std::string_view val) {
+        Status s = check(key, val);
+        if (s == Status::OK) push(Op::Put, key, val, nullptr);
+        return s;
+    }
+
+    /// \brief Fire-and-forget Delete (Multi-Producer).
+    Status post_del(std::string_view key) {
+        Status s = check(key, {});
+        if (s == Status::OK) push(Op::Del, key, {}, nullptr);
+        return s;
+    }
+
+    /// \brief Put (Multi-Producer) completing with the engine's Status once applied.
+    std::future<Status> put(std::string_view key, std::string_view val) {
+        return submit(Op::Put, key, val);
+    }
+
+    /// \brief Delete (Multi-Producer) completing with OK or NotFound once applied.
+    std::future<Status> del(std::string_view key) {
+        return submit(Op::Del, key, {});
+    }
+
+    /// \brief Blocks until every command enqueued before this call has been applied.
+    void flush() { submit(Op::Flush, {}, {}).wait(); }
+
+    std::uint32_t capacity() const { return capacity_; }
+
+private:
+    enum class Op : std::uint8_t { Put, Del, Flush };
+
+    /// \brief Ring cell. Padded so producers filling adjacent cells do not share a line.
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> seq{0};
+        Op op = Op::Flush;
+        std::uint16_t klen = 0;
+        std::string buf; // Key bytes followed by value bytes; capacity is reused.
+        std::optional<std::promise<Status>> done;
+
+        std::string_view key() const { return std::string_view(buf).substr(0, klen); }
+        std::string_view val() const { return std::string_view(buf).substr(klen); }
+    };
+
+    static Status check(std::string_view key, std::string_view val) {
+        if (key.size() > MAX_KEY) return Status::KeyTooLong;
+        if (val.size() > MAX_VAL) return Status::ValTooLong;
+        return Status::OK;
+    }
+
+    std::future<Status> submit(Op op, std::string_view key, std::string_view val) {
+        std::promise<Status> p;
+        std::future<Status> f = p.get_future();
+        Status s = check(key, val);
+        if (s != Status::OK) {
+            p.set_value(s);
+        } else {
+            push(op, key, val, &p);
+        }
+        return f;
+    }
+
+    /// \brief Claims the tail cell, fills it and publishes it to the writer.
+    /// \details Spins (then yields) while the ring is full.
+    void push(Op op, std::string_view key, std::string_view val, std::promise<Status>* done) {
+        std::uint64_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* c;
+        for (std::uint32_t spins = 0;;) {
+            c = &cells_[pos & mask_];
+            std::int64_t dif = static_cast<std::int64_t>(c->seq.load(std::memory_order_acquire) - pos);
+            if (dif == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                // Full: the writer has not released this cell yet.
+                if (++spins < 64) cpu_relax(); else std::this_thread::yield();
+                pos = tail_.load(std::memory_order_relaxed);
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        c->op = op;
+        c->klen = static_cast<std::uint16_t>(key.size());
+        c->buf.assign(key);
+        c->buf.append(val);
+        if (done) c->done.emplace(std::move(*done));
+        c->seq.store(pos + 1, std::memory_order_release);
+
+        // Pairs with the fence in run(): either the writer sees this cell or we see it idle.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle_.load(std::memory_order_relaxed)) wake();
+    }
+
+    void wake() {
+        idle_.store(false, std::memory_order_relaxed);
+        idle_.notify_one();
+    }
+
+    bool ready(std::uint64_t pos) const {
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    static void finish(Cell& c, Status s) {
+        if (c.done) {
+            c.done->set_value(s);
+            c.done.reset();
+        }
+    }
+
+    /// \brief Applies up to DRAIN_BATCH ready commands and releases their cells.
+    /// \return Number of commands applied.
+    std::uint32_t drain() {
+        std::uint32_t n = 0;
+        while (n < DRAIN_BATCH && ready(head_ + n)) ++n;
+
+        for(std::uint32_t i=0; i<n;) {
+            Cell& c = cells_[(head_ + i) & mask_];
+            if (c.op != Op::Put) {
+                finish(c, c.op == Op::Del ? db_.del(c.key()) : Status::OK);
+                ++i;
+                continue;
+            }
+
+            // Coalesce the run of consecutive puts into one batch.
+            std::uint32_t j = i;
+            batch_.clear();
+            for (; j < n; ++j) {
+                Cell& p = cells_[(head_ + j) & mask_];
+                if (p.op != Op::Put) break;
+                batch_.push_back({p.key(), p.val()});
+            }
+
+            Status s = (batch_.size() == 1) ? db_.put(batch_[0].key, batch_[0].val) : db_.write_batch(batch_);
+            for(std::uint32_t k=i; k<j; ++k) {
+                Cell& p = cells_[(head_ + k) & mask_];
+                // A failed batch is replayed key by key so each command gets its own Status.
+                // Re-putting entries the batch already published is idempotent.
+                finish(p, (s == Status::OK || batch_.size() == 1) ? s : db_.put(p.key(), p.val()));
+            }
+            i = j;
+        }
+
+        for(std::uint32_t i=0; i<n; ++i) {
+            cells_[(head_ + i) & mask_].seq.store(head_ + i + capacity_, std::memory_order_release);
+        }
+        head_ += n;
+        return n;
+    }
+
+    /// \brief Writer thread: drain, spin briefly when empty, then park until a producer wakes it.
+    void run() {
+        for (std::uint32_t spins = 0;;) {
+            if (drain() != 0) { spins = 0; continue; }
+            if (stop_.load(std::memory_order_acquire)) {
+                while (drain() != 0) {}
+                return;
+            }
+            if (++spins < 256) { cpu_relax(); continue; }
+
+            idle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready(head_) && !stop_.load(std::memory_order_acquire)) idle_.wait(true, std::memory_order_acquire);
+            idle_.store(false, std::memory_order_relaxed);
+            spins = 0;
+        }
+    }
+
+    DB& db_;
+    const std::uint32_t capacity_;
+    const std::uint32_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    alignas(64) std::atomic<bool> idle_{false};
+    std::atomic<bool> stop_{false};
+
+    // Writer-thread state.
+    alignas(64) std::uint64_t head_ = 0;
+    std::vector<KeyValue> batch_;
+    std::thread writer_;
+};
+
+using WriteQueue = BasicWriteQueue<>;